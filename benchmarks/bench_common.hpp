@@ -0,0 +1,400 @@
+#pragma once
+
+// Shared helpers for the standalone (non Google Benchmark) benchmark drivers
+
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace orderbook {
+namespace benchmark {
+
+// Peak resident set size of this process in kilobytes
+inline std::uint64_t peak_rss_kb() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss) / 1024;  // bytes on macOS
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss);         // kilobytes on Linux
+#endif
+}
+
+// Current resident set size of this process in kilobytes (0 if unknown)
+inline std::uint64_t current_rss_kb() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::uint64_t total_pages = 0;
+    std::uint64_t resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        return resident_pages * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    }
+#endif
+    return 0;
+}
+
+// Seconds elapsed since a steady_clock time point
+inline double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Split a comma separated option value ("1000000,10000000")
+inline std::vector<std::string> split_list(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+inline std::string json_escape(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size() + 2);
+    for (char c : value) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:   escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+// Minimal JSON object builder for benchmark results
+class JsonObject {
+public:
+    JsonObject& add(const std::string& key, const std::string& value) {
+        return add_raw(key, "\"" + json_escape(value) + "\"");
+    }
+
+    JsonObject& add(const std::string& key, const char* value) {
+        return add(key, std::string(value));
+    }
+
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    JsonObject& add(const std::string& key, T value) {
+        std::ostringstream oss;
+        if constexpr (std::is_same_v<T, bool>) {
+            oss << (value ? "true" : "false");
+        } else if constexpr (std::is_floating_point_v<T>) {
+            oss << std::setprecision(10) << value;
+        } else {
+            oss << value;
+        }
+        return add_raw(key, oss.str());
+    }
+
+    // Value already encoded as JSON (nested object or array)
+    JsonObject& add_raw(const std::string& key, const std::string& json) {
+        fields_.emplace_back("\"" + json_escape(key) + "\": " + json);
+        return *this;
+    }
+
+    std::string str() const {
+        std::string out = "{";
+        for (std::size_t i = 0; i < fields_.size(); ++i) {
+            out += (i == 0 ? "" : ", ") + fields_[i];
+        }
+        return out + "}";
+    }
+
+private:
+    std::vector<std::string> fields_;
+};
+
+inline std::string json_array(const std::vector<std::string>& items) {
+    std::string out = "[\n";
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        out += "    " + items[i] + (i + 1 < items.size() ? ",\n" : "\n");
+    }
+    return out + "  ]";
+}
+
+// UTC wall-clock time for result files
+inline std::string utc_timestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm {};
+    gmtime_r(&now, &tm);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buffer;
+}
+
+inline bool write_text_file(const std::string& path, const std::string& content) {
+    std::ofstream output(path);
+    if (!output.is_open()) {
+        return false;
+    }
+    output << content;
+    return static_cast<bool>(output);
+}
+
+// Keep the compiler from discarding a computed value
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Serialized timestamp counter read (steady_clock nanoseconds off x86)
+inline std::uint64_t cycle_now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    const std::uint64_t tsc = __rdtsc();
+    _mm_lfence();
+    return tsc;
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Counter ticks per nanosecond, calibrated once against steady_clock
+inline double cycles_per_ns() {
+    static const double ratio = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        const auto wall_start = std::chrono::steady_clock::now();
+        const std::uint64_t tsc_start = cycle_now();
+        while (std::chrono::steady_clock::now() - wall_start < std::chrono::milliseconds(100)) {
+        }
+        const std::uint64_t tsc_end = cycle_now();
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - wall_start).count();
+        return static_cast<double>(tsc_end - tsc_start) / ns;
+#else
+        return 1.0;
+#endif
+    }();
+    return ratio;
+}
+
+// Latency distribution summary in nanoseconds
+struct LatencySummary {
+    std::size_t count = 0;
+    double mean_ns = 0.0;
+    double p50_ns = 0.0;
+    double p90_ns = 0.0;
+    double p99_ns = 0.0;
+    double p999_ns = 0.0;
+    double p9999_ns = 0.0;
+    double max_ns = 0.0;
+};
+
+// Collects per-operation cycle counts and reports percentiles and a histogram
+class LatencyRecorder {
+public:
+    void reserve(std::size_t count) { samples_.reserve(count); }
+    void clear() noexcept { samples_.clear(); }
+    void record(std::uint64_t cycles) { samples_.push_back(cycles); }
+    std::size_t size() const noexcept { return samples_.size(); }
+
+    // Sorts the samples in place
+    LatencySummary summarize() {
+        LatencySummary summary;
+        if (samples_.empty()) {
+            return summary;
+        }
+        std::sort(samples_.begin(), samples_.end());
+
+        const double scale = 1.0 / cycles_per_ns();
+        double total = 0.0;
+        for (auto sample : samples_) {
+            total += static_cast<double>(sample);
+        }
+
+        summary.count = samples_.size();
+        summary.mean_ns = total / samples_.size() * scale;
+        summary.p50_ns = percentile(0.50) * scale;
+        summary.p90_ns = percentile(0.90) * scale;
+        summary.p99_ns = percentile(0.99) * scale;
+        summary.p999_ns = percentile(0.999) * scale;
+        summary.p9999_ns = percentile(0.9999) * scale;
+        summary.max_ns = static_cast<double>(samples_.back()) * scale;
+        return summary;
+    }
+
+    // Counts per power-of-two nanosecond bucket: index b covers [2^b, 2^(b+1)) ns
+    std::vector<std::uint64_t> histogram() const {
+        std::vector<std::uint64_t> buckets;
+        const double scale = 1.0 / cycles_per_ns();
+        for (auto sample : samples_) {
+            const double ns = std::max(1.0, static_cast<double>(sample) * scale);
+            const auto bucket = static_cast<std::size_t>(std::log2(ns));
+            if (bucket >= buckets.size()) {
+                buckets.resize(bucket + 1, 0);
+            }
+            ++buckets[bucket];
+        }
+        return buckets;
+    }
+
+    void print_histogram(std::ostream& out) const {
+        const auto buckets = histogram();
+        const std::uint64_t peak = buckets.empty() ? 1 : *std::max_element(buckets.begin(), buckets.end());
+        for (std::size_t b = 0; b < buckets.size(); ++b) {
+            if (buckets[b] == 0) {
+                continue;
+            }
+            const auto width = static_cast<std::size_t>(50.0 * buckets[b] / peak);
+            out << "    " << std::right << std::setw(10) << (1ull << b) << " - "
+                << std::left << std::setw(10) << (1ull << (b + 1)) << " ns "
+                << std::right << std::setw(10) << buckets[b] << " "
+                << std::string(std::max<std::size_t>(width, 1), '#') << "\n";
+        }
+    }
+
+    std::string histogram_json() const {
+        std::string out = "[";
+        const auto buckets = histogram();
+        bool first = true;
+        for (std::size_t b = 0; b < buckets.size(); ++b) {
+            if (buckets[b] == 0) {
+                continue;
+            }
+            if (!first) {
+                out += ", ";
+            }
+            out += JsonObject()
+                .add("lower_ns", 1ull << b)
+                .add("upper_ns", 1ull << (b + 1))
+                .add("count", buckets[b])
+                .str();
+            first = false;
+        }
+        return out + "]";
+    }
+
+private:
+    std::vector<std::uint64_t> samples_;
+
+    double percentile(double q) const {
+        const auto index = static_cast<std::size_t>(std::ceil(q * samples_.size())) - 1;
+        return static_cast<double>(samples_[std::min(index, samples_.size() - 1)]);
+    }
+};
+
+// Hardware event counter for this thread (Linux perf_event_open).
+//
+// Counts user-space events only, so it works with the default
+// perf_event_paranoid setting. available() is false when the kernel,
+// container or VM does not expose the event; callers then omit the figure.
+class PerfCounter {
+public:
+    enum class Event {
+        LLC_LOAD_MISSES,
+        DTLB_LOAD_MISSES,
+        INSTRUCTIONS,
+    };
+
+    explicit PerfCounter(Event event) {
+#ifdef __linux__
+        struct perf_event_attr attr {};
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        switch (event) {
+            case Event::LLC_LOAD_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case Event::DTLB_LOAD_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case Event::INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+        }
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd_ < 0 && event == Event::LLC_LOAD_MISSES) {
+            // Some PMUs only expose the generic last-level miss event
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#else
+        (void)event;
+#endif
+    }
+
+    ~PerfCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    bool available() const noexcept { return fd_ >= 0; }
+
+    void start() noexcept {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Stops counting and returns the count since start()
+    std::uint64_t stop() noexcept {
+        std::uint64_t count = 0;
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+inline JsonObject latency_json(const LatencySummary& summary) {
+    return JsonObject()
+        .add("count", summary.count)
+        .add("mean_ns", summary.mean_ns)
+        .add("p50_ns", summary.p50_ns)
+        .add("p90_ns", summary.p90_ns)
+        .add("p99_ns", summary.p99_ns)
+        .add("p99_9_ns", summary.p999_ns)
+        .add("p99_99_ns", summary.p9999_ns)
+        .add("max_ns", summary.max_ns);
+}
+
+} // namespace benchmark
+} // namespace orderbook
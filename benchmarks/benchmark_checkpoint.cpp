@@ -0,0 +1,236 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include "bench_common.hpp"
+#include <filesystem>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Checkpoint cost benchmark.
+//
+// For books of increasing size: image size, synchronous save and load time
+// (the stall a checkpoint on the processing thread costs), and for the
+// fork-based BackgroundCheckpointer the parent's pause plus the p99/max
+// per-record latency of the flow processed while the child is writing
+// (copy-on-write faults land there) against the same flow without one.
+// Then the delta checkpoint of one more interval of flow: its size and the
+// time to write it and to apply it on top of the full image.
+
+namespace orderbook {
+namespace benchmark {
+
+namespace fs = std::filesystem;
+
+class CheckpointBenchmark {
+public:
+    std::vector<std::size_t> book_sizes = {100000, 1000000, 5000000};
+    std::size_t records = 200000;
+    std::uint64_t seed = 42;
+    std::string work_dir = fs::temp_directory_path().string();
+    std::string json_output;
+
+    int run() {
+        std::cout << "Checkpoint Cost Benchmark\n";
+        std::cout << "=========================\n";
+        std::cout << records << " records timed with and without a background checkpoint in flight\n\n";
+
+        std::cout << std::right << std::setw(10) << "Orders" << std::setw(10) << "Image MB"
+                  << std::setw(10) << "Save ms" << std::setw(10) << "Load ms"
+                  << std::setw(11) << "Pause ms" << std::setw(11) << "Child ms"
+                  << std::setw(11) << "p99 ns" << std::setw(11) << "p99 bg"
+                  << std::setw(11) << "max ns" << std::setw(11) << "max bg" << "\n";
+        std::cout << std::string(106, '-') << "\n";
+
+        std::vector<std::string> results;
+        for (std::size_t book_size : book_sizes) {
+            results.push_back(run_scenario(book_size));
+        }
+
+        std::cout << "\nDelta checkpoint after " << records << " more records\n";
+        std::cout << std::right << std::setw(10) << "Orders" << std::setw(10) << "Image MB"
+                  << std::setw(10) << "Delta MB" << std::setw(10) << "Save ms" << std::setw(10) << "Apply ms" << "\n";
+        std::cout << std::string(50, '-') << "\n";
+        for (const auto& row : delta_rows_) {
+            std::cout << row << "\n";
+        }
+
+        if (!json_output.empty()) {
+            const std::string json = JsonObject()
+                .add("benchmark", "checkpoint")
+                .add("timestamp", utc_timestamp())
+                .add("seed", seed)
+                .add("records", records)
+                .add_raw("results", json_array(results))
+                .str();
+            if (!write_text_file(json_output, json + "\n")) {
+                std::cerr << "Cannot write " << json_output << "\n";
+                return 1;
+            }
+            std::cout << "\nResults written to: " << json_output << "\n";
+        }
+        return 0;
+    }
+
+private:
+    std::vector<std::string> delta_rows_;
+
+    std::string run_scenario(std::size_t book_size) {
+        MarketGeneratorConfig config;
+        config.seed = seed;
+        config.initial_depth = book_size;
+        config.target_resting_orders = book_size;
+        MarketGenerator generator(config);
+
+        auto orderbook = std::make_unique<Orderbook>();
+        for (std::size_t i = 0; i < book_size; ++i) {
+            orderbook->process_mbo_record(generator.next());
+        }
+        const std::vector<MBORecord> flow = generator.generate(records * 3);
+
+        const std::string path = (fs::path(work_dir) / ("book_" + std::to_string(::getpid()) + ".ckpt")).string();
+        const CheckpointPosition position;
+
+        auto start = std::chrono::steady_clock::now();
+        orderbook->save_checkpoint(path, position);
+        const double save_ms = seconds_since(start) * 1e3;
+        const double image_mb = static_cast<double>(fs::file_size(path)) / (1 << 20);
+
+        start = std::chrono::steady_clock::now();
+        {
+            Orderbook restored;
+            restored.load_checkpoint(path);
+            do_not_optimize(restored.order_count());
+        }
+        const double load_ms = seconds_since(start) * 1e3;
+
+        // Baseline flow, then the same amount with a child writing
+        const LatencySummary baseline = time_flow(*orderbook, flow, 0, records);
+        BackgroundCheckpointer checkpointer;
+        checkpointer.start(*orderbook, path, position);
+        const LatencySummary during = time_flow(*orderbook, flow, records, records * 2);
+        checkpointer.wait();
+        const auto& stats = checkpointer.stats();
+
+        // One more interval of flow as a delta on a fresh full image
+        orderbook->save_checkpoint(path, position);
+        orderbook->set_change_tracking(true);
+        for (std::size_t i = records * 2; i < flow.size(); ++i) {
+            orderbook->process_mbo_record(flow[i]);
+        }
+        std::stringstream delta;
+        start = std::chrono::steady_clock::now();
+        orderbook->save_delta(delta, position, position);
+        const double delta_save_ms = seconds_since(start) * 1e3;
+        const double delta_mb = static_cast<double>(delta.str().size()) / (1 << 20);
+        double delta_apply_ms = 0;
+        {
+            Orderbook restored;
+            restored.load_checkpoint(path);
+            start = std::chrono::steady_clock::now();
+            restored.apply_delta(delta, position);
+            delta_apply_ms = seconds_since(start) * 1e3;
+            do_not_optimize(restored.order_count());
+        }
+        fs::remove(path);
+
+        const double pause_ms = stats.max_pause.count() / 1e6;
+        const double child_ms = stats.max_write.count() / 1e6;
+        const std::size_t orders = orderbook->order_count();
+
+        std::cout << std::right << std::setw(10) << orders << std::fixed << std::setprecision(1)
+                  << std::setw(10) << image_mb << std::setw(10) << save_ms << std::setw(10) << load_ms
+                  << std::setprecision(2) << std::setw(11) << pause_ms
+                  << std::setprecision(1) << std::setw(11) << child_ms
+                  << std::setprecision(0) << std::setw(11) << baseline.p99_ns << std::setw(11) << during.p99_ns
+                  << std::setw(11) << baseline.max_ns << std::setw(11) << during.max_ns << "\n";
+        if (stats.failed > 0) {
+            std::cout << "  background checkpoint failed\n";
+        }
+        std::ostringstream delta_row;
+        delta_row << std::right << std::setw(10) << orders << std::fixed << std::setprecision(1)
+                  << std::setw(10) << image_mb << std::setprecision(2) << std::setw(10) << delta_mb
+                  << std::setw(10) << delta_save_ms << std::setw(10) << delta_apply_ms;
+        delta_rows_.push_back(delta_row.str());
+
+        return JsonObject()
+            .add("book_size", book_size)
+            .add("resting_orders", orders)
+            .add("image_bytes", static_cast<std::uint64_t>(image_mb * (1 << 20)))
+            .add("save_ms", save_ms)
+            .add("load_ms", load_ms)
+            .add("fork_pause_ms", pause_ms)
+            .add("child_write_ms", child_ms)
+            .add("delta_bytes", static_cast<std::uint64_t>(delta.str().size()))
+            .add("delta_save_ms", delta_save_ms)
+            .add("delta_apply_ms", delta_apply_ms)
+            .add_raw("latency", latency_json(baseline).str())
+            .add_raw("latency_during_checkpoint", latency_json(during).str())
+            .str();
+    }
+
+    static LatencySummary time_flow(Orderbook& orderbook, const std::vector<MBORecord>& flow,
+                                    std::size_t begin, std::size_t end) {
+        LatencyRecorder recorder;
+        recorder.reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::uint64_t t0 = cycle_now();
+            orderbook.process_mbo_record(flow[i]);
+            MBPRecord snapshot = orderbook.generate_mbp_record(flow[i]);
+            do_not_optimize(snapshot);
+            recorder.record(cycle_now() - t0);
+        }
+        return recorder.summarize();
+    }
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --book-sizes N,N,...  Resting orders (default 100000,1000000,5000000)\n"
+              << "  --records N           Records timed per phase (default 200000)\n"
+              << "  --dir PATH            Directory for checkpoint files (default system temp)\n"
+              << "  --seed S              Generator seed (default 42)\n"
+              << "  --json FILE           Write results as JSON\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    orderbook::benchmark::CheckpointBenchmark bench;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--book-sizes") {
+            bench.book_sizes.clear();
+            for (const auto& item : orderbook::benchmark::split_list(value)) {
+                bench.book_sizes.push_back(std::stoull(item));
+            }
+        } else if (arg == "--records") {
+            bench.records = std::stoull(value);
+        } else if (arg == "--dir") {
+            bench.work_dir = value;
+        } else if (arg == "--seed") {
+            bench.seed = std::stoull(value);
+        } else if (arg == "--json") {
+            bench.json_output = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    return bench.run();
+}
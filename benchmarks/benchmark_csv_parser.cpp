@@ -1,6 +1,6 @@
 #include "orderbook.hpp"
+#include "market_generator.hpp"
 #include <benchmark/benchmark.h>
-#include <random>
 #include <vector>
 #include <sstream>
 
@@ -10,38 +10,26 @@ namespace benchmark {
 // Benchmark fixture for CSV parser tests
 class CSVParserBenchmark : public ::benchmark::Fixture {
 protected:
+    // Every registration needs an argument (0 when the lines are unused)
     void SetUp(const ::benchmark::State& state) override {
-        // Generate test CSV lines
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<price_t> price_dist(900000, 1100000);
-        std::uniform_int_distribution<size_t> size_dist(1, 1000);
-        std::uniform_int_distribution<order_id_t> id_dist(1, 1000000);
+        // Generate test CSV lines in the exact input format
+        MarketGeneratorConfig config;
+        config.seed = 20250717;
+        MarketGenerator generator(config);
         
         test_lines_.reserve(state.range(0));
-        for (std::size_t i = 0; i < state.range(0); ++i) {
-            std::ostringstream oss;
-            oss << i * 1000 << ","  // ts_recv
-                << i * 1000 << ","  // ts_event
-                << "160,"            // rtype
-                << "2,"              // publisher_id
-                << "1108,"           // instrument_id
-                << "A,"              // action
-                << "B,"              // side
-                << price_dist(gen) << ","  // price
-                << size_dist(gen) << ","   // size
-                << "1,"              // channel_id
-                << id_dist(gen) << ","     // order_id
-                << "0,"              // flags
-                << "0,"              // ts_in_delta
-                << i << ","          // sequence
-                << "BENCH";          // symbol
-            
-            test_lines_.push_back(oss.str());
+        for (std::int64_t i = 0; i < state.range(0); ++i) {
+            test_lines_.push_back(MarketGenerator::format_mbo_line(generator.next()));
         }
     }
     
-    void TearDown(const ::benchmark::State& state) override {
+    // A single representative input line
+    static std::string sample_line() {
+        MarketGenerator generator;
+        return MarketGenerator::format_mbo_line(generator.next());
+    }
+    
+    void TearDown(const ::benchmark::State& /*state*/) override {
         test_lines_.clear();
     }
     
@@ -68,7 +56,7 @@ BENCHMARK_REGISTER_F(CSVParserBenchmark, ParseThroughput)
 
 // Benchmark: Single line parsing
 BENCHMARK_DEFINE_F(CSVParserBenchmark, SingleLineParse)(::benchmark::State& state) {
-    std::string test_line = "1000,1000,160,2,1108,A,B,1000000,100,1,12345,0,0,0,BENCH";
+    const std::string test_line = sample_line();
     
     for (auto _ : state) {
         ::benchmark::DoNotOptimize(CSVParser::parse_mbo_line(test_line));
@@ -79,33 +67,24 @@ BENCHMARK_DEFINE_F(CSVParserBenchmark, SingleLineParse)(::benchmark::State& stat
 }
 
 BENCHMARK_REGISTER_F(CSVParserBenchmark, SingleLineParse)
+    ->Arg(0)
     ->Unit(::benchmark::kNanosecond);
 
 // Benchmark: MBP record formatting
 BENCHMARK_DEFINE_F(CSVParserBenchmark, MBPFormatting)(::benchmark::State& state) {
-    // Create a sample MBP record
-    MBPRecord record;
-    record.timestamp.ts_recv = 1000;
-    record.timestamp.ts_event = 1000;
-    record.rtype = RecordType::MBP;
-    record.publisher_id = 2;
-    record.instrument_id = 1108;
-    record.action = Action::ADD;
-    record.side = Side::BID;
-    record.depth = 0;
-    record.price = 1000000;
-    record.size = 100;
-    record.flags = 0;
-    record.ts_in_delta = 0;
-    record.sequence = 0;
-    record.symbol = "BENCH";
-    record.order_id = 12345;
-    
-    // Fill bid levels
-    for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
-        record.bid_levels[i] = PriceLevel(1000000 - i * 1000, 100 - i * 10, 1);
-        record.ask_levels[i] = PriceLevel(1000000 + i * 1000, 100 + i * 10, 1);
+    // Snapshot of a realistic full book
+    MarketGeneratorConfig config;
+    config.seed = 20250717;
+    config.initial_depth = 1000;
+    MarketGenerator generator(config);
+    
+    Orderbook orderbook;
+    MBORecord last;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        last = generator.next();
+        orderbook.process_mbo_record(last);
     }
+    const MBPRecord record = orderbook.generate_mbp_record(last);
     
     for (auto _ : state) {
         ::benchmark::DoNotOptimize(CSVParser::format_mbp_record(record));
@@ -116,17 +95,20 @@ BENCHMARK_DEFINE_F(CSVParserBenchmark, MBPFormatting)(::benchmark::State& state)
 }
 
 BENCHMARK_REGISTER_F(CSVParserBenchmark, MBPFormatting)
+    ->Arg(0)
     ->Unit(::benchmark::kMicrosecond);
 
 // Benchmark: String to number conversion
 BENCHMARK_DEFINE_F(CSVParserBenchmark, StringToNumber)(::benchmark::State& state) {
-    std::vector<std::string> numbers = {
-        "1000000",
-        "5500000",
-        "21330000",
-        "5900000",
-        "10000000"
-    };
+    // Numeric fields (size, order_id, sequence) of generated lines
+    MarketGenerator generator;
+    std::vector<std::string> numbers;
+    for (std::size_t i = 0; i < 64; ++i) {
+        const auto record = generator.next();
+        numbers.push_back(std::to_string(record.size));
+        numbers.push_back(std::to_string(record.order_id));
+        numbers.push_back(std::to_string(record.sequence));
+    }
     
     std::size_t index = 0;
     for (auto _ : state) {
@@ -139,11 +121,12 @@ BENCHMARK_DEFINE_F(CSVParserBenchmark, StringToNumber)(::benchmark::State& state
 }
 
 BENCHMARK_REGISTER_F(CSVParserBenchmark, StringToNumber)
+    ->Arg(0)
     ->Unit(::benchmark::kNanosecond);
 
 // Benchmark: Field splitting
 BENCHMARK_DEFINE_F(CSVParserBenchmark, FieldSplitting)(::benchmark::State& state) {
-    std::string test_line = "1000,1000,160,2,1108,A,B,1000000,100,1,12345,0,0,0,BENCH";
+    const std::string test_line = sample_line();
     
     for (auto _ : state) {
         std::vector<std::string> fields;
@@ -168,6 +151,7 @@ BENCHMARK_DEFINE_F(CSVParserBenchmark, FieldSplitting)(::benchmark::State& state
 }
 
 BENCHMARK_REGISTER_F(CSVParserBenchmark, FieldSplitting)
+    ->Arg(0)
     ->Unit(::benchmark::kNanosecond);
 
 // Benchmark: Memory allocation for parsing
@@ -175,10 +159,9 @@ BENCHMARK_DEFINE_F(CSVParserBenchmark, ParseMemoryAllocation)(::benchmark::State
     std::vector<std::string> test_lines;
     test_lines.reserve(state.range(0));
     
-    for (std::size_t i = 0; i < state.range(0); ++i) {
-        std::ostringstream oss;
-        oss << i * 1000 << "," << i * 1000 << ",160,2,1108,A,B,1000000,100,1,12345,0,0,0,BENCH";
-        test_lines.push_back(oss.str());
+    MarketGenerator generator;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        test_lines.push_back(MarketGenerator::format_mbo_line(generator.next()));
     }
     
     for (auto _ : state) {
@@ -218,6 +201,7 @@ BENCHMARK_DEFINE_F(CSVParserBenchmark, ErrorHandling)(::benchmark::State& state)
 }
 
 BENCHMARK_REGISTER_F(CSVParserBenchmark, ErrorHandling)
+    ->Arg(0)
     ->Unit(::benchmark::kNanosecond);
 
 } // namespace benchmark
@@ -0,0 +1,213 @@
+#include "orderbook.hpp"
+#include "book_engine.hpp"
+#include "market_generator.hpp"
+#include "bench_common.hpp"
+#include "heap_tracking.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Book-engine benchmark matrix.
+//
+// Runs the same generated workloads against every registered BookEngine and
+// prints throughput, p50/p99 latency of apply + top-of-book snapshot, and
+// heap bytes per resting order (tracked by the global allocator in
+// heap_tracking.hpp).
+
+namespace orderbook {
+namespace benchmark {
+
+struct EngineWorkload {
+    std::string name;
+    std::string description;
+    MarketGeneratorConfig config;
+    std::size_t warmup_records;   // Untimed book build
+};
+
+std::vector<EngineWorkload> default_workloads(std::uint64_t seed) {
+    std::vector<EngineWorkload> workloads;
+
+    MarketGeneratorConfig balanced;
+    balanced.seed = seed;
+    workloads.push_back({"balanced", "default add/cancel/trade flow, ~1K resting orders", balanced, 0});
+
+    MarketGeneratorConfig deep = balanced;
+    deep.initial_depth = 100000;
+    deep.target_resting_orders = 100000;
+    deep.mean_level_distance = 200.0;
+    workloads.push_back({"deep", "100K resting orders over ~thousands of levels", deep, deep.initial_depth});
+
+    MarketGeneratorConfig sweeps = balanced;
+    sweeps.trade_probability = 0.15;
+    sweeps.max_sweep_levels = 8;
+    workloads.push_back({"sweeps", "trade-heavy flow with multi-level sweeps", sweeps, 0});
+
+    MarketGeneratorConfig build = balanced;
+    build.cancel_to_add_ratio = 0.0;
+    build.trade_probability = 0.0;
+    workloads.push_back({"build", "add-only book build", build, 0});
+
+    return workloads;
+}
+
+class EngineMatrixBenchmark {
+public:
+    std::size_t records = 1000000;
+    std::uint64_t seed = 42;
+    std::vector<std::string> engine_filter;
+    std::vector<std::string> workload_filter;
+    std::string json_output;
+
+    int run() {
+        std::cout << "Book Engine Benchmark Matrix\n";
+        std::cout << "============================\n";
+        std::cout << "Registered engines:\n";
+        for (const auto& engine : registered_book_engines()) {
+            std::cout << "  " << std::left << std::setw(12) << engine.name << engine.description << "\n";
+        }
+        std::cout << "\n";
+
+        std::cout << std::left << std::setw(10) << "Workload" << std::setw(12) << "Engine"
+                  << std::right << std::setw(12) << "Mrec/s" << std::setw(10) << "p50 ns"
+                  << std::setw(10) << "p99 ns" << std::setw(12) << "Bytes/ord"
+                  << std::setw(10) << "Orders" << "\n";
+        std::cout << std::string(76, '-') << "\n";
+
+        std::vector<std::string> results;
+        for (const auto& workload : default_workloads(seed)) {
+            if (!selected(workload_filter, workload.name)) {
+                continue;
+            }
+
+            // Identical input for every engine
+            MarketGenerator generator(workload.config);
+            const std::vector<MBORecord> warmup = generator.generate(workload.warmup_records);
+            const std::vector<MBORecord> flow = generator.generate(records);
+
+            for (const auto& engine : registered_book_engines()) {
+                if (!selected(engine_filter, engine.name)) {
+                    continue;
+                }
+                results.push_back(run_cell(workload, engine, warmup, flow));
+            }
+        }
+
+        if (!json_output.empty()) {
+            const std::string json = JsonObject()
+                .add("benchmark", "engine_matrix")
+                .add("timestamp", utc_timestamp())
+                .add("seed", seed)
+                .add("records", records)
+                .add_raw("results", json_array(results))
+                .str();
+            if (!write_text_file(json_output, json + "\n")) {
+                std::cerr << "Cannot write " << json_output << "\n";
+                return 1;
+            }
+            std::cout << "\nResults written to: " << json_output << "\n";
+        }
+        return 0;
+    }
+
+private:
+    static bool selected(const std::vector<std::string>& filter, const std::string& name) {
+        return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+    }
+
+    std::string run_cell(const EngineWorkload& workload, const BookEngineInfo& info,
+                         const std::vector<MBORecord>& warmup, const std::vector<MBORecord>& flow) {
+        LatencyRecorder recorder;
+        recorder.reserve(flow.size());
+
+        const std::int64_t heap_before = tracked_heap_bytes();
+        std::unique_ptr<BookEngine> engine = info.create();
+
+        for (const auto& record : warmup) {
+            engine->apply(record);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& record : flow) {
+            const std::uint64_t begin = cycle_now();
+            engine->apply(record);
+            auto bids = engine->top_levels(Side::BID);
+            auto asks = engine->top_levels(Side::ASK);
+            do_not_optimize(bids);
+            do_not_optimize(asks);
+            recorder.record(cycle_now() - begin);
+        }
+        const double wall = seconds_since(start);
+
+        const std::size_t orders = engine->order_count();
+        const std::int64_t heap_bytes = tracked_heap_bytes() - heap_before;
+        const double bytes_per_order = orders ? static_cast<double>(heap_bytes) / orders : 0.0;
+        engine.reset();
+
+        const LatencySummary summary = recorder.summarize();
+        const double throughput = flow.size() / wall;
+
+        std::cout << std::left << std::setw(10) << workload.name << std::setw(12) << info.name
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(12) << throughput / 1e6
+                  << std::setprecision(0) << std::setw(10) << summary.p50_ns
+                  << std::setw(10) << summary.p99_ns
+                  << std::setprecision(1) << std::setw(12) << bytes_per_order
+                  << std::setw(10) << orders << "\n";
+
+        return latency_json(summary)
+            .add("workload", workload.name)
+            .add("engine", info.name)
+            .add("records_per_second", throughput)
+            .add("bytes_per_order", bytes_per_order)
+            .add("resting_orders", orders)
+            .str();
+    }
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --records N          Timed records per workload (default 1000000)\n"
+              << "  --engines E,E,...    Only run these engines (default all registered)\n"
+              << "  --workloads W,W,...  balanced,deep,sweeps,build (default all)\n"
+              << "  --seed S             Generator seed (default 42)\n"
+              << "  --json FILE          Write results as JSON\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    orderbook::benchmark::EngineMatrixBenchmark bench;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--records") {
+            bench.records = std::stoull(value);
+        } else if (arg == "--engines") {
+            bench.engine_filter = orderbook::benchmark::split_list(value);
+        } else if (arg == "--workloads") {
+            bench.workload_filter = orderbook::benchmark::split_list(value);
+        } else if (arg == "--seed") {
+            bench.seed = std::stoull(value);
+        } else if (arg == "--json") {
+            bench.json_output = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    return bench.run();
+}
@@ -0,0 +1,278 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include "bench_common.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// End-to-end throughput of OrderbookProcessor::process_file on generated files.
+//
+// Every measurement runs in a forked child so peak RSS is per run and the
+// parent's generation work does not pollute it. Cold runs drop the input
+// from the page cache first; warm runs read it once before timing.
+
+namespace orderbook {
+namespace benchmark {
+
+namespace fs = std::filesystem;
+
+struct FileRunResult {
+    double wall_seconds = 0.0;
+    std::uint64_t peak_rss_kb = 0;
+    std::uint64_t output_bytes = 0;
+    int ok = 0;
+};
+
+class FileThroughputBenchmark {
+public:
+    std::vector<std::size_t> sizes = {1000000, 10000000, 100000000};
+    std::vector<std::string> modes = {"cold", "warm"};
+    std::string work_dir = fs::temp_directory_path().string();
+    std::string json_output = "file_throughput.json";
+    std::uint64_t seed = 42;
+    std::size_t repeat = 1;
+    bool keep_files = false;
+
+    int run() {
+        std::vector<std::string> results;
+
+        std::cout << "End-to-end File Throughput Benchmark\n";
+        std::cout << "====================================\n\n";
+        std::cout << std::left << std::setw(12) << "Records" << std::setw(7) << "Mode"
+                  << std::right << std::setw(10) << "Wall (s)" << std::setw(14) << "Records/s"
+                  << std::setw(11) << "MB/s in" << std::setw(11) << "MB/s out"
+                  << std::setw(14) << "Peak RSS MB" << "\n";
+
+        for (std::size_t records : sizes) {
+            const std::string input = generate_input(records);
+            const std::uint64_t input_bytes = fs::file_size(input);
+            const std::string output = (fs::path(work_dir) / ("mbp_" + std::to_string(records) + ".csv")).string();
+
+            for (const auto& mode : modes) {
+                for (std::size_t r = 0; r < repeat; ++r) {
+                    if (mode == "cold" && !drop_page_cache(input)) {
+                        std::cerr << "  cold mode unsupported on this platform, skipping\n";
+                        break;
+                    }
+                    if (mode == "warm") {
+                        prewarm(input);
+                    }
+
+                    const FileRunResult result = run_child(input, output);
+                    if (!result.ok) {
+                        std::cerr << "  run failed for " << records << " records (" << mode << ")\n";
+                        return 1;
+                    }
+
+                    const double records_per_second = records / result.wall_seconds;
+                    const double mb_in = input_bytes / 1e6 / result.wall_seconds;
+                    const double mb_out = result.output_bytes / 1e6 / result.wall_seconds;
+
+                    std::cout << std::left << std::setw(12) << records << std::setw(7) << mode
+                              << std::right << std::fixed << std::setprecision(3)
+                              << std::setw(10) << result.wall_seconds
+                              << std::setprecision(0) << std::setw(14) << records_per_second
+                              << std::setprecision(1) << std::setw(11) << mb_in
+                              << std::setw(11) << mb_out
+                              << std::setw(14) << result.peak_rss_kb / 1024.0 << "\n";
+
+                    results.push_back(JsonObject()
+                        .add("records", records)
+                        .add("mode", mode)
+                        .add("repetition", r)
+                        .add("wall_seconds", result.wall_seconds)
+                        .add("records_per_second", records_per_second)
+                        .add("input_bytes", input_bytes)
+                        .add("output_bytes", result.output_bytes)
+                        .add("input_mb_per_second", mb_in)
+                        .add("output_mb_per_second", mb_out)
+                        .add("peak_rss_kb", result.peak_rss_kb)
+                        .str());
+                }
+            }
+
+            fs::remove(output);
+            if (!keep_files) {
+                fs::remove(input);
+            }
+        }
+
+        const std::string json = JsonObject()
+            .add("benchmark", "file_throughput")
+            .add("timestamp", utc_timestamp())
+            .add("seed", seed)
+            .add_raw("results", json_array(results))
+            .str();
+
+        if (!write_text_file(json_output, json + "\n")) {
+            std::cerr << "Cannot write " << json_output << "\n";
+            return 1;
+        }
+        std::cout << "\nResults written to: " << json_output << "\n";
+        return 0;
+    }
+
+private:
+    std::string generate_input(std::size_t records) {
+        const fs::path path = fs::path(work_dir) /
+            ("mbo_" + std::to_string(records) + "_" + std::to_string(seed) + ".csv");
+
+        if (keep_files && fs::exists(path)) {
+            std::cout << "Reusing " << path.string() << "\n";
+            return path.string();
+        }
+
+        std::cout << "Generating " << records << " records -> " << path.string() << "\n";
+        auto start = std::chrono::steady_clock::now();
+
+        MarketGeneratorConfig config;
+        config.seed = seed;
+        MarketGenerator generator(config);
+
+        std::vector<char> buffer(1 << 20);
+        std::ofstream output;
+        output.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        output.open(path);
+        generator.write_csv(output, records);
+        output.close();
+
+        std::cout << "  generated in " << std::fixed << std::setprecision(1)
+                  << seconds_since(start) << " s\n";
+        return path.string();
+    }
+
+    // Flush the file to disk and ask the kernel to evict its pages
+    static bool drop_page_cache(const std::string& path) {
+#ifdef __linux__
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        ::fdatasync(fd);
+        const int rc = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+        return rc == 0;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    static void prewarm(const std::string& path) {
+        std::ifstream input(path, std::ios::binary);
+        std::vector<char> buffer(1 << 20);
+        while (input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0) {
+        }
+    }
+
+    static FileRunResult run_child(const std::string& input, const std::string& output) {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            return {};
+        }
+        std::cout.flush();  // Don't let the child inherit buffered report lines
+
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(fds[0]);
+            // Keep process_file's progress messages out of the report
+            if (!std::freopen("/dev/null", "w", stdout)) {
+                ::_exit(1);
+            }
+
+            FileRunResult result;
+            try {
+                OrderbookProcessor processor;
+                processor.set_buffer_size(16384);
+
+                auto start = std::chrono::steady_clock::now();
+                processor.process_file(input, output);
+                result.wall_seconds = seconds_since(start);
+                result.peak_rss_kb = peak_rss_kb();
+                result.output_bytes = fs::file_size(output);
+                result.ok = 1;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+            }
+
+            [[maybe_unused]] auto written = ::write(fds[1], &result, sizeof(result));
+            ::close(fds[1]);
+            ::_exit(0);
+        }
+
+        ::close(fds[1]);
+        FileRunResult result;
+        if (pid < 0 || ::read(fds[0], &result, sizeof(result)) != static_cast<ssize_t>(sizeof(result))) {
+            result = {};
+        }
+        ::close(fds[0]);
+        if (pid > 0) {
+            ::waitpid(pid, nullptr, 0);
+        }
+        return result;
+    }
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --sizes N,N,...   Input sizes in records (default 1000000,10000000,100000000)\n"
+              << "  --modes M,M       Page cache modes: cold,warm (default both)\n"
+              << "  --dir PATH        Directory for generated files (default system temp)\n"
+              << "  --json FILE       Result file (default file_throughput.json)\n"
+              << "  --repeat R        Repetitions per size and mode (default 1)\n"
+              << "  --seed S          Generator seed (default 42)\n"
+              << "  --keep            Keep (and reuse) generated input files\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    orderbook::benchmark::FileThroughputBenchmark bench;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--keep") {
+            bench.keep_files = true;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--sizes") {
+            bench.sizes.clear();
+            for (const auto& item : orderbook::benchmark::split_list(value)) {
+                bench.sizes.push_back(std::stoull(item));
+            }
+        } else if (arg == "--modes") {
+            bench.modes = orderbook::benchmark::split_list(value);
+        } else if (arg == "--dir") {
+            bench.work_dir = value;
+        } else if (arg == "--json") {
+            bench.json_output = value;
+        } else if (arg == "--repeat") {
+            bench.repeat = std::stoull(value);
+        } else if (arg == "--seed") {
+            bench.seed = std::stoull(value);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    return bench.run();
+}
@@ -0,0 +1,217 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include "bench_common.hpp"
+#include "heap_tracking.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Large-book cache-pressure benchmark.
+//
+// Builds books of millions of resting orders spread over thousands of price
+// levels, then times a realistic add/cancel/trade flow in which cancels and
+// fills hit orders anywhere in the book. Reports throughput, last-level
+// cache and dTLB load misses per record (when perf counters are available)
+// and heap bytes per resting order, so order_lookup_ and level-map misses
+// show up the way they do on deep-book and options days.
+
+namespace orderbook {
+namespace benchmark {
+
+class LargeBookBenchmark {
+public:
+    std::vector<std::size_t> book_sizes = {1000000, 5000000, 20000000};
+    std::size_t records = 1000000;
+    double level_distance = 1000.0;
+    std::uint64_t seed = 42;
+    std::string json_output;
+
+    int run() {
+        // Only allocations made inside the book are counted
+        set_heap_tracking(false);
+
+        std::cout << "Large Book Cache-Pressure Benchmark\n";
+        std::cout << "===================================\n";
+        std::cout << records << " timed records per book size, mean level distance "
+                  << level_distance << " ticks\n";
+
+        PerfCounter probe(PerfCounter::Event::LLC_LOAD_MISSES);
+        if (!probe.available()) {
+            std::cout << "Hardware counters unavailable (perf_event_open failed); miss columns omitted\n";
+        }
+        std::cout << "\n";
+
+        std::cout << std::right << std::setw(10) << "Orders" << std::setw(9) << "Levels"
+                  << std::setw(12) << "Build s" << std::setw(10) << "Mrec/s"
+                  << std::setw(10) << "ns/rec" << std::setw(11) << "LLC/rec"
+                  << std::setw(11) << "dTLB/rec" << std::setw(11) << "Bytes/ord"
+                  << std::setw(10) << "RSS MB" << "\n";
+        std::cout << std::string(94, '-') << "\n";
+
+        std::vector<std::string> results;
+        for (std::size_t book_size : book_sizes) {
+            results.push_back(run_scenario(book_size));
+        }
+
+        if (!json_output.empty()) {
+            const std::string json = JsonObject()
+                .add("benchmark", "large_book")
+                .add("timestamp", utc_timestamp())
+                .add("seed", seed)
+                .add("records", records)
+                .add("level_distance_ticks", level_distance)
+                .add("peak_rss_kb", peak_rss_kb())
+                .add_raw("results", json_array(results))
+                .str();
+            if (!write_text_file(json_output, json + "\n")) {
+                std::cerr << "Cannot write " << json_output << "\n";
+                return 1;
+            }
+            std::cout << "\nResults written to: " << json_output << "\n";
+        }
+        return 0;
+    }
+
+private:
+    std::string run_scenario(std::size_t book_size) {
+        MarketGeneratorConfig config;
+        config.seed = seed;
+        config.initial_depth = book_size;
+        config.target_resting_orders = book_size;
+        config.mean_level_distance = level_distance;
+        MarketGenerator generator(config);
+
+        auto orderbook = std::make_unique<Orderbook>();
+        const std::int64_t heap_before = tracked_heap_bytes();
+
+        // Build the resting book, streaming so the adds are never held in memory
+        const auto build_start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < book_size; ++i) {
+            MBORecord record = generator.next();
+            set_heap_tracking(true);
+            orderbook->process_mbo_record(record);
+            set_heap_tracking(false);
+        }
+        const double build_seconds = seconds_since(build_start);
+
+        const std::vector<MBORecord> flow = generator.generate(records);
+
+        PerfCounter llc_misses(PerfCounter::Event::LLC_LOAD_MISSES);
+        PerfCounter dtlb_misses(PerfCounter::Event::DTLB_LOAD_MISSES);
+
+        set_heap_tracking(true);
+        llc_misses.start();
+        dtlb_misses.start();
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& record : flow) {
+            orderbook->process_mbo_record(record);
+            MBPRecord snapshot = orderbook->generate_mbp_record(record);
+            do_not_optimize(snapshot);
+        }
+        const double wall = seconds_since(start);
+        const std::uint64_t llc = llc_misses.stop();
+        const std::uint64_t dtlb = dtlb_misses.stop();
+        set_heap_tracking(false);
+
+        const std::size_t orders = orderbook->order_count();
+        const std::size_t levels = orderbook->level_count();
+        const double bytes_per_order = orders ?
+            static_cast<double>(tracked_heap_bytes() - heap_before) / orders : 0.0;
+        const std::uint64_t rss_kb = current_rss_kb();
+
+        set_heap_tracking(true);
+        orderbook.reset();
+        set_heap_tracking(false);
+
+        const double throughput = flow.size() / wall;
+        const double ns_per_record = wall * 1e9 / flow.size();
+        const double llc_per_record = static_cast<double>(llc) / flow.size();
+        const double dtlb_per_record = static_cast<double>(dtlb) / flow.size();
+
+        std::cout << std::right << std::setw(10) << orders << std::setw(9) << levels
+                  << std::fixed << std::setprecision(2) << std::setw(12) << build_seconds
+                  << std::setw(10) << throughput / 1e6
+                  << std::setprecision(0) << std::setw(10) << ns_per_record
+                  << std::setprecision(2);
+        if (llc_misses.available()) {
+            std::cout << std::setw(11) << llc_per_record;
+        } else {
+            std::cout << std::setw(11) << "n/a";
+        }
+        if (dtlb_misses.available()) {
+            std::cout << std::setw(11) << dtlb_per_record;
+        } else {
+            std::cout << std::setw(11) << "n/a";
+        }
+        std::cout << std::setprecision(1) << std::setw(11) << bytes_per_order
+                  << std::setprecision(0) << std::setw(10) << rss_kb / 1024.0 << "\n";
+
+        JsonObject result;
+        result.add("book_size", book_size)
+            .add("resting_orders", orders)
+            .add("price_levels", levels)
+            .add("build_seconds", build_seconds)
+            .add("records_per_second", throughput)
+            .add("ns_per_record", ns_per_record)
+            .add("bytes_per_order", bytes_per_order)
+            .add("rss_kb", rss_kb);
+        if (llc_misses.available()) {
+            result.add("llc_misses_per_record", llc_per_record);
+        }
+        if (dtlb_misses.available()) {
+            result.add("dtlb_misses_per_record", dtlb_per_record);
+        }
+        return result.str();
+    }
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --book-sizes N,N,...  Resting orders before timing (default 1000000,5000000,20000000)\n"
+              << "  --records N           Timed records per book size (default 1000000)\n"
+              << "  --level-distance T    Mean order distance from the touch in ticks (default 1000)\n"
+              << "  --seed S              Generator seed (default 42)\n"
+              << "  --json FILE           Write results as JSON\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    orderbook::benchmark::LargeBookBenchmark bench;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--book-sizes") {
+            bench.book_sizes.clear();
+            for (const auto& item : orderbook::benchmark::split_list(value)) {
+                bench.book_sizes.push_back(std::stoull(item));
+            }
+        } else if (arg == "--records") {
+            bench.records = std::stoull(value);
+        } else if (arg == "--level-distance") {
+            bench.level_distance = std::stod(value);
+        } else if (arg == "--seed") {
+            bench.seed = std::stoull(value);
+        } else if (arg == "--json") {
+            bench.json_output = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    return bench.run();
+}
@@ -0,0 +1,154 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include "bench_common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+
+// Per-record latency distribution of process_mbo_record + generate_mbp_record.
+//
+// Each scenario builds a book of the given size from generated adds
+// (untimed), then times every record of a realistic add/cancel/trade flow
+// with the timestamp counter and reports p50..p99.99, max and a histogram.
+
+namespace orderbook {
+namespace benchmark {
+
+class LatencyBenchmark {
+public:
+    std::vector<std::size_t> book_sizes = {0, 1000, 10000, 100000, 1000000};
+    std::size_t records = 1000000;
+    std::uint64_t seed = 42;
+    std::string json_output;
+    bool show_histogram = true;
+
+    int run() {
+        std::cout << "Record Latency Distribution Benchmark\n";
+        std::cout << "=====================================\n";
+        std::cout << "Timer: " << std::fixed << std::setprecision(3) << cycles_per_ns()
+                  << " ticks/ns, " << records << " timed records per book size\n\n";
+
+        std::vector<std::string> results;
+        for (std::size_t book_size : book_sizes) {
+            results.push_back(run_scenario(book_size));
+        }
+
+        if (!json_output.empty()) {
+            const std::string json = JsonObject()
+                .add("benchmark", "record_latency")
+                .add("timestamp", utc_timestamp())
+                .add("seed", seed)
+                .add("records", records)
+                .add_raw("results", json_array(results))
+                .str();
+            if (!write_text_file(json_output, json + "\n")) {
+                std::cerr << "Cannot write " << json_output << "\n";
+                return 1;
+            }
+            std::cout << "Results written to: " << json_output << "\n";
+        }
+        return 0;
+    }
+
+private:
+    std::string run_scenario(std::size_t book_size) {
+        MarketGeneratorConfig config;
+        config.seed = seed;
+        config.initial_depth = book_size;
+        config.target_resting_orders = std::max<std::size_t>(book_size, 1);
+        MarketGenerator generator(config);
+
+        // Build the resting book (untimed)
+        Orderbook orderbook;
+        for (std::size_t i = 0; i < book_size; ++i) {
+            orderbook.process_mbo_record(generator.next());
+        }
+
+        const std::vector<MBORecord> flow = generator.generate(records);
+
+        LatencyRecorder recorder;
+        recorder.reserve(flow.size());
+
+        for (const auto& record : flow) {
+            const std::uint64_t start = cycle_now();
+            orderbook.process_mbo_record(record);
+            MBPRecord snapshot = orderbook.generate_mbp_record(record);
+            do_not_optimize(snapshot);
+            recorder.record(cycle_now() - start);
+        }
+
+        const LatencySummary summary = recorder.summarize();
+
+        std::cout << "Book size " << book_size << " resting orders\n";
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  mean " << summary.mean_ns << " ns"
+                  << "  p50 " << summary.p50_ns
+                  << "  p90 " << summary.p90_ns
+                  << "  p99 " << summary.p99_ns
+                  << "  p99.9 " << summary.p999_ns
+                  << "  p99.99 " << summary.p9999_ns
+                  << "  max " << summary.max_ns << " ns\n";
+        if (show_histogram) {
+            recorder.print_histogram(std::cout);
+        }
+        std::cout << "\n";
+
+        return latency_json(summary)
+            .add("book_size", book_size)
+            .add("final_resting_orders", generator.resting_orders())
+            .add_raw("histogram", recorder.histogram_json())
+            .str();
+    }
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --book-sizes N,N,...  Resting orders before timing (default 0,1000,10000,100000,1000000)\n"
+              << "  --records N           Timed records per book size (default 1000000)\n"
+              << "  --seed S              Generator seed (default 42)\n"
+              << "  --json FILE           Write results as JSON\n"
+              << "  --no-histogram        Only print percentiles\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    orderbook::benchmark::LatencyBenchmark bench;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-histogram") {
+            bench.show_histogram = false;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--book-sizes") {
+            bench.book_sizes.clear();
+            for (const auto& item : orderbook::benchmark::split_list(value)) {
+                bench.book_sizes.push_back(std::stoull(item));
+            }
+        } else if (arg == "--records") {
+            bench.records = std::stoull(value);
+        } else if (arg == "--seed") {
+            bench.seed = std::stoull(value);
+        } else if (arg == "--json") {
+            bench.json_output = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    return bench.run();
+}
@@ -0,0 +1,372 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <zlib.h>
+
+// Output-path micro-benchmarks.
+//
+// Splits the cost of producing MBP output into its parts: field formatting
+// (price, timestamp, whole row) in ns/row, and writing pre-formatted rows
+// through ofstream, stdio and write(2) at several buffer sizes, gzip at two
+// levels and a fixed-size binary row format (bytes_per_second). Formatting
+// is also swept over thread counts. All rows are snapshots of a generated
+// book deep enough that every one of the 10 levels per side is populated.
+
+namespace orderbook {
+namespace benchmark {
+
+namespace {
+
+constexpr std::size_t SNAPSHOT_ROWS = 4096;
+
+// Snapshots taken along a realistic flow over a deep book
+const std::vector<MBPRecord>& snapshots() {
+    static const std::vector<MBPRecord> rows = [] {
+        MarketGeneratorConfig config;
+        config.seed = 20250717;
+        config.initial_depth = 5000;
+        config.target_resting_orders = 5000;
+        MarketGenerator generator(config);
+
+        Orderbook orderbook;
+        for (std::size_t i = 0; i < config.initial_depth; ++i) {
+            orderbook.process_mbo_record(generator.next());
+        }
+
+        std::vector<MBPRecord> result;
+        result.reserve(SNAPSHOT_ROWS);
+        while (result.size() < SNAPSHOT_ROWS) {
+            const MBORecord record = generator.next();
+            orderbook.process_mbo_record(record);
+            result.push_back(orderbook.generate_mbp_record(record));
+        }
+        return result;
+    }();
+    return rows;
+}
+
+const std::vector<std::string>& formatted_rows() {
+    static const std::vector<std::string> rows = [] {
+        std::vector<std::string> result;
+        result.reserve(SNAPSHOT_ROWS);
+        for (const auto& snapshot : snapshots()) {
+            result.push_back(CSVParser::format_mbp_record(snapshot) + "\n");
+        }
+        return result;
+    }();
+    return rows;
+}
+
+std::size_t formatted_bytes() {
+    std::size_t bytes = 0;
+    for (const auto& row : formatted_rows()) {
+        bytes += row.size();
+    }
+    return bytes;
+}
+
+// Fixed-size binary MBP row (native endianness, no padding)
+#pragma pack(push, 1)
+struct BinaryMbpRow {
+    std::int64_t ts_recv;
+    std::int64_t ts_event;
+    std::uint32_t instrument_id;
+    std::uint16_t publisher_id;
+    char action;
+    char side;
+    std::int64_t price;
+    std::uint32_t size;
+    std::uint32_t flags;
+    std::uint64_t sequence;
+    std::uint64_t order_id;
+    struct Level {
+        std::int64_t price;
+        std::uint32_t size;
+        std::uint32_t count;
+    } bids[MAX_DEPTH], asks[MAX_DEPTH];
+};
+#pragma pack(pop)
+
+BinaryMbpRow to_binary(const MBPRecord& record) {
+    BinaryMbpRow row {};
+    row.ts_recv = record.timestamp.ts_recv;
+    row.ts_event = record.timestamp.ts_event;
+    row.instrument_id = record.instrument_id;
+    row.publisher_id = record.publisher_id;
+    row.action = static_cast<char>(record.action);
+    row.side = static_cast<char>(record.side);
+    row.price = record.price;
+    row.size = record.size;
+    row.flags = record.flags;
+    row.sequence = record.sequence;
+    row.order_id = record.order_id;
+    for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
+        row.bids[i] = {record.bid_levels[i].price, record.bid_levels[i].size, record.bid_levels[i].count};
+        row.asks[i] = {record.ask_levels[i].price, record.ask_levels[i].size, record.ask_levels[i].count};
+    }
+    return row;
+}
+
+// Scratch file removed when the benchmark finishes
+class ScratchFile {
+public:
+    explicit ScratchFile(const std::string& tag)
+        : path_((std::filesystem::temp_directory_path() /
+                 ("orderbook_output_" + tag + "_" + std::to_string(getpid()))).string()) {}
+    ~ScratchFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+    }
+    const std::string& path() const noexcept { return path_; }
+
+private:
+    std::string path_;
+};
+
+void set_rows_per_second(::benchmark::State& state, std::size_t rows_per_iteration) {
+    state.counters["rows_per_second"] = ::benchmark::Counter(
+        static_cast<double>(state.iterations() * rows_per_iteration), ::benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Formatting, one row per iteration (Time column = ns/row)
+
+// The 41 prices of a row: trade price + 10 levels per side
+static void BM_FormatPricesPerRow(::benchmark::State& state) {
+    const auto& rows = snapshots();
+    std::size_t index = 0;
+    for (auto _ : state) {
+        const MBPRecord& row = rows[index++ % rows.size()];
+        ::benchmark::DoNotOptimize(CSVParser::format_price(row.price));
+        for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
+            ::benchmark::DoNotOptimize(CSVParser::format_price(row.bid_levels[i].price));
+            ::benchmark::DoNotOptimize(CSVParser::format_price(row.ask_levels[i].price));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatPricesPerRow)->Unit(::benchmark::kNanosecond);
+
+// ts_recv + ts_event
+static void BM_FormatTimestampsPerRow(::benchmark::State& state) {
+    const auto& rows = snapshots();
+    std::size_t index = 0;
+    for (auto _ : state) {
+        const MBPRecord& row = rows[index++ % rows.size()];
+        ::benchmark::DoNotOptimize(CSVParser::format_timestamp(row.timestamp.ts_recv));
+        ::benchmark::DoNotOptimize(CSVParser::format_timestamp(row.timestamp.ts_event));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatTimestampsPerRow)->Unit(::benchmark::kNanosecond);
+
+// Whole row via CSVParser::format_mbp_record; threads format independently
+static void BM_FormatRow(::benchmark::State& state) {
+    const auto& rows = snapshots();
+    std::size_t index = static_cast<std::size_t>(state.thread_index()) * 97;
+    for (auto _ : state) {
+        ::benchmark::DoNotOptimize(CSVParser::format_mbp_record(rows[index++ % rows.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatRow)
+    ->ThreadRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+    ->UseRealTime()
+    ->Unit(::benchmark::kNanosecond);
+
+// Fixed-size binary encoding of a row
+static void BM_EncodeBinaryRow(::benchmark::State& state) {
+    const auto& rows = snapshots();
+    std::size_t index = 0;
+    for (auto _ : state) {
+        ::benchmark::DoNotOptimize(to_binary(rows[index++ % rows.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeBinaryRow)->Unit(::benchmark::kNanosecond);
+
+// ---------------------------------------------------------------------------
+// Writers: SNAPSHOT_ROWS pre-formatted rows per iteration (bytes_per_second)
+
+// std::ofstream, as in OrderbookProcessor; arg = stream buffer bytes (0 = default)
+static void BM_WriteOfstream(::benchmark::State& state) {
+    const auto& rows = formatted_rows();
+    ScratchFile file("ofstream");
+    std::vector<char> buffer(static_cast<std::size_t>(state.range(0)));
+
+    std::ofstream output;
+    if (!buffer.empty()) {
+        output.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+    output.open(file.path(), std::ios::binary | std::ios::trunc);
+
+    for (auto _ : state) {
+        output.seekp(0);
+        for (const auto& row : rows) {
+            output << row;
+        }
+        output.flush();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * formatted_bytes()));
+    set_rows_per_second(state, rows.size());
+}
+BENCHMARK(BM_WriteOfstream)->Arg(0)->Arg(4 << 10)->Arg(64 << 10)->Arg(1 << 20)->Unit(::benchmark::kMicrosecond);
+
+// stdio with setvbuf; arg = buffer bytes
+static void BM_WriteStdio(::benchmark::State& state) {
+    const auto& rows = formatted_rows();
+    ScratchFile file("stdio");
+    std::FILE* output = std::fopen(file.path().c_str(), "wb");
+    if (!output) {
+        state.SkipWithError("cannot open scratch file");
+        return;
+    }
+    std::vector<char> buffer(static_cast<std::size_t>(state.range(0)));
+    std::setvbuf(output, buffer.data(), _IOFBF, buffer.size());
+
+    for (auto _ : state) {
+        std::fseek(output, 0, SEEK_SET);
+        for (const auto& row : rows) {
+            std::fwrite(row.data(), 1, row.size(), output);
+        }
+        std::fflush(output);
+    }
+    std::fclose(output);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * formatted_bytes()));
+    set_rows_per_second(state, rows.size());
+}
+BENCHMARK(BM_WriteStdio)->Arg(4 << 10)->Arg(64 << 10)->Arg(1 << 20)->Unit(::benchmark::kMicrosecond);
+
+// Own buffer flushed with write(2); arg = buffer bytes
+static void BM_WriteSyscall(::benchmark::State& state) {
+    const auto& rows = formatted_rows();
+    ScratchFile file("syscall");
+    std::FILE* handle = std::fopen(file.path().c_str(), "wb");
+    if (!handle) {
+        state.SkipWithError("cannot open scratch file");
+        return;
+    }
+    const int fd = fileno(handle);
+    std::vector<char> buffer(static_cast<std::size_t>(state.range(0)));
+    bool failed = false;
+
+    auto flush = [&](std::size_t used) {
+        failed |= ::write(fd, buffer.data(), used) != static_cast<ssize_t>(used);
+    };
+
+    for (auto _ : state) {
+        lseek(fd, 0, SEEK_SET);
+        std::size_t used = 0;
+        for (const auto& row : rows) {
+            if (used + row.size() > buffer.size()) {
+                flush(used);
+                used = 0;
+            }
+            std::memcpy(buffer.data() + used, row.data(), row.size());
+            used += row.size();
+        }
+        flush(used);
+    }
+    std::fclose(handle);
+    if (failed) {
+        state.SkipWithError("write failed");
+        return;
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * formatted_bytes()));
+    set_rows_per_second(state, rows.size());
+}
+BENCHMARK(BM_WriteSyscall)->Arg(4 << 10)->Arg(64 << 10)->Arg(1 << 20)->Unit(::benchmark::kMicrosecond);
+
+// gzip-compressed CSV; arg = compression level (bytes counted uncompressed)
+static void BM_WriteGzip(::benchmark::State& state) {
+    const auto& rows = formatted_rows();
+    ScratchFile file("gzip");
+    const std::string mode = "wb" + std::to_string(state.range(0));
+    std::uintmax_t compressed = 0;
+
+    for (auto _ : state) {
+        gzFile output = gzopen(file.path().c_str(), mode.c_str());
+        if (!output) {
+            state.SkipWithError("cannot open scratch file");
+            return;
+        }
+        gzbuffer(output, 1 << 20);
+        for (const auto& row : rows) {
+            gzwrite(output, row.data(), static_cast<unsigned>(row.size()));
+        }
+        gzclose(output);
+    }
+    compressed = std::filesystem::file_size(file.path());
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * formatted_bytes()));
+    set_rows_per_second(state, rows.size());
+    state.counters["compression_ratio"] = static_cast<double>(formatted_bytes()) / static_cast<double>(compressed);
+}
+BENCHMARK(BM_WriteGzip)->Arg(1)->Arg(6)->Unit(::benchmark::kMicrosecond);
+
+// Binary rows, encode + stdio write; arg = buffer bytes
+static void BM_WriteBinary(::benchmark::State& state) {
+    const auto& rows = snapshots();
+    ScratchFile file("binary");
+    std::FILE* output = std::fopen(file.path().c_str(), "wb");
+    if (!output) {
+        state.SkipWithError("cannot open scratch file");
+        return;
+    }
+    std::vector<char> buffer(static_cast<std::size_t>(state.range(0)));
+    std::setvbuf(output, buffer.data(), _IOFBF, buffer.size());
+
+    for (auto _ : state) {
+        std::fseek(output, 0, SEEK_SET);
+        for (const auto& row : rows) {
+            const BinaryMbpRow binary = to_binary(row);
+            std::fwrite(&binary, sizeof(binary), 1, output);
+        }
+        std::fflush(output);
+    }
+    std::fclose(output);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * rows.size() * sizeof(BinaryMbpRow)));
+    set_rows_per_second(state, rows.size());
+}
+BENCHMARK(BM_WriteBinary)->Arg(64 << 10)->Arg(1 << 20)->Unit(::benchmark::kMicrosecond);
+
+// ---------------------------------------------------------------------------
+// Format + write, the full CSV output path; threads write separate files
+
+static void BM_FormatAndWrite(::benchmark::State& state) {
+    const auto& rows = snapshots();
+    ScratchFile file("full_" + std::to_string(state.thread_index()));
+    std::ofstream output(file.path(), std::ios::binary | std::ios::trunc);
+    std::size_t bytes = 0;
+
+    for (auto _ : state) {
+        output.seekp(0);
+        for (const auto& row : rows) {
+            const std::string formatted = CSVParser::format_mbp_record(row);
+            output << formatted << "\n";
+            bytes += formatted.size() + 1;
+        }
+        output.flush();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    set_rows_per_second(state, rows.size());
+}
+BENCHMARK(BM_FormatAndWrite)
+    ->ThreadRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+    ->UseRealTime()
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace benchmark
+} // namespace orderbook
+
+BENCHMARK_MAIN();
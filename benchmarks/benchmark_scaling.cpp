@@ -0,0 +1,395 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include "bench_common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Multi-instrument scaling benchmark.
+//
+// A generated stream for K instruments is fed by a dispatcher thread to T
+// worker threads; every record is applied to its instrument's book, turned
+// into an MBP snapshot and formatted as an output row. Two layouts are
+// measured:
+//
+//   sharded    each worker owns the books of instruments (index % T) and
+//              does apply + snapshot + format for them
+//   pipelined  one book thread does apply + snapshot, T-1 formatter threads
+//              format the rows round-robin (T = 1 formats inline)
+//
+// Books are never shared between threads. Latency is dispatch-to-row for
+// each record, so at full offered load (--rate 0) it includes queueing.
+
+namespace orderbook {
+namespace benchmark {
+
+// Bounded single-producer single-consumer ring
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) : slots_(round_up(capacity)), mask_(slots_.size() - 1) {}
+
+    bool try_push(T&& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == slots_.size()) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == slots_.size()) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Spin briefly, then yield so oversubscribed runs still make progress
+    void push(T&& value) {
+        for (std::uint32_t spins = 0; !try_push(std::move(value)); ++spins) {
+            backoff(spins);
+        }
+    }
+
+    void pop(T& value) {
+        for (std::uint32_t spins = 0; !try_pop(value); ++spins) {
+            backoff(spins);
+        }
+    }
+
+private:
+    std::vector<T> slots_;
+    const std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;  // Consumer's view of tail_
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;  // Producer's view of head_
+
+    static std::size_t round_up(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static void backoff(std::uint32_t spins) {
+        if (spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+class ScalingBenchmark {
+public:
+    std::vector<std::size_t> instrument_counts = {1, 10, 100, 1000, 10000};
+    std::vector<std::size_t> thread_counts = default_thread_counts();
+    std::vector<std::string> modes = {"sharded", "pipelined"};
+    std::size_t records = 1000000;
+    std::size_t resting_orders = 100000;  // Across all instruments
+    double rate = 0.0;                    // Offered records/s, 0 = as fast as possible
+    std::size_t queue_capacity = 4096;
+    std::uint64_t seed = 42;
+    std::string json_output;
+
+    int run() {
+        std::cout << "Multi-Instrument Scaling Benchmark\n";
+        std::cout << "==================================\n";
+        std::cout << records << " records per configuration, " << resting_orders
+                  << " resting orders, " << std::thread::hardware_concurrency() << " hardware threads, "
+                  << (rate > 0 ? std::to_string(static_cast<std::uint64_t>(rate)) + " rec/s offered"
+                               : std::string("saturated input")) << "\n";
+        std::cout << "Worker threads exclude the dispatcher thread\n\n";
+
+        std::cout << std::left << std::setw(11) << "Mode" << std::right << std::setw(8) << "K"
+                  << std::setw(5) << "T" << std::setw(10) << "Mrec/s" << std::setw(9) << "Speedup"
+                  << std::setw(11) << "p50 ns" << std::setw(11) << "p99 ns" << "\n";
+        std::cout << std::string(65, '-') << "\n";
+
+        std::vector<std::string> results;
+        for (std::size_t instruments : instrument_counts) {
+            MarketGeneratorConfig config;
+            config.seed = seed;
+            config.instrument_count = instruments;
+            config.target_resting_orders = std::max<std::size_t>(resting_orders / instruments, 10);
+            config.initial_depth = config.target_resting_orders;
+            MarketGenerator generator(config);
+
+            const std::vector<MBORecord> warmup = generator.generate(config.initial_depth * instruments);
+            const std::vector<MBORecord> flow = generator.generate(records);
+
+            for (const auto& mode : modes) {
+                double single_thread = 0.0;
+                for (std::size_t threads : thread_counts) {
+                    const Result result = run_config(mode, config, threads, warmup, flow);
+                    if (single_thread == 0.0) {
+                        single_thread = result.throughput;
+                    }
+                    const double speedup = result.throughput / single_thread;
+
+                    std::cout << std::left << std::setw(11) << mode << std::right << std::setw(8) << instruments
+                              << std::setw(5) << threads << std::fixed << std::setprecision(2)
+                              << std::setw(10) << result.throughput / 1e6 << std::setw(9) << speedup
+                              << std::setprecision(0) << std::setw(11) << result.latency.p50_ns
+                              << std::setw(11) << result.latency.p99_ns << "\n";
+
+                    results.push_back(latency_json(result.latency)
+                        .add("mode", mode)
+                        .add("instruments", instruments)
+                        .add("threads", threads)
+                        .add("records_per_second", result.throughput)
+                        .add("speedup", speedup)
+                        .str());
+                }
+            }
+        }
+
+        if (!json_output.empty()) {
+            const std::string json = JsonObject()
+                .add("benchmark", "instrument_scaling")
+                .add("timestamp", utc_timestamp())
+                .add("seed", seed)
+                .add("records", records)
+                .add("resting_orders", resting_orders)
+                .add("offered_rate", rate)
+                .add("hardware_threads", std::thread::hardware_concurrency())
+                .add_raw("results", json_array(results))
+                .str();
+            if (!write_text_file(json_output, json + "\n")) {
+                std::cerr << "Cannot write " << json_output << "\n";
+                return 1;
+            }
+            std::cout << "\nResults written to: " << json_output << "\n";
+        }
+        return 0;
+    }
+
+    static std::vector<std::size_t> default_thread_counts() {
+        const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::size_t> counts;
+        for (std::size_t t = 1; t < cores; t *= 2) {
+            counts.push_back(t);
+        }
+        counts.push_back(cores);
+        return counts;
+    }
+
+private:
+    static constexpr std::uint32_t END_OF_STREAM = ~0u;
+
+    struct Result {
+        double throughput = 0.0;
+        LatencySummary latency;
+    };
+
+    struct FormatTask {
+        std::uint32_t index = END_OF_STREAM;
+        MBPRecord snapshot;
+    };
+
+    Result run_config(const std::string& mode, const MarketGeneratorConfig& config, std::size_t threads,
+                      const std::vector<MBORecord>& warmup, const std::vector<MBORecord>& flow) {
+        // One book per instrument, built untimed
+        std::vector<std::unique_ptr<Orderbook>> books(config.instrument_count);
+        for (auto& book : books) {
+            book = std::make_unique<Orderbook>();
+        }
+        for (const auto& record : warmup) {
+            books[record.instrument_id - config.first_instrument_id]->process_mbo_record(record);
+        }
+
+        std::vector<std::uint64_t> dispatched(flow.size());
+        std::vector<std::uint64_t> latency(flow.size());
+
+        auto finish = [&](std::uint32_t index, const MBPRecord& snapshot) {
+            std::string row = CSVParser::format_mbp_record(snapshot);
+            do_not_optimize(row);
+            latency[index] = cycle_now() - dispatched[index];
+        };
+        auto book_for = [&](const MBORecord& record) -> Orderbook& {
+            return *books[record.instrument_id - config.first_instrument_id];
+        };
+
+        std::vector<std::unique_ptr<SpscRing<std::uint32_t>>> inputs;
+        std::vector<std::unique_ptr<SpscRing<FormatTask>>> outputs;
+        std::vector<std::thread> workers;
+
+        if (mode == "sharded") {
+            for (std::size_t w = 0; w < threads; ++w) {
+                inputs.push_back(std::make_unique<SpscRing<std::uint32_t>>(queue_capacity));
+            }
+            for (std::size_t w = 0; w < threads; ++w) {
+                workers.emplace_back([&, w] {
+                    std::uint32_t index = 0;
+                    for (inputs[w]->pop(index); index != END_OF_STREAM; inputs[w]->pop(index)) {
+                        const MBORecord& record = flow[index];
+                        Orderbook& book = book_for(record);
+                        book.process_mbo_record(record);
+                        finish(index, book.generate_mbp_record(record));
+                    }
+                });
+            }
+        } else {
+            inputs.push_back(std::make_unique<SpscRing<std::uint32_t>>(queue_capacity));
+            const std::size_t formatters = threads - 1;
+            for (std::size_t f = 0; f < formatters; ++f) {
+                outputs.push_back(std::make_unique<SpscRing<FormatTask>>(queue_capacity));
+            }
+            workers.emplace_back([&, formatters] {
+                std::uint32_t index = 0;
+                for (inputs[0]->pop(index); index != END_OF_STREAM; inputs[0]->pop(index)) {
+                    const MBORecord& record = flow[index];
+                    Orderbook& book = book_for(record);
+                    book.process_mbo_record(record);
+                    if (formatters == 0) {
+                        finish(index, book.generate_mbp_record(record));
+                    } else {
+                        outputs[index % formatters]->push(FormatTask{index, book.generate_mbp_record(record)});
+                    }
+                }
+                for (auto& output : outputs) {
+                    output->push(FormatTask{});
+                }
+            });
+            for (std::size_t f = 0; f < formatters; ++f) {
+                workers.emplace_back([&, f] {
+                    FormatTask task;
+                    for (outputs[f]->pop(task); task.index != END_OF_STREAM; outputs[f]->pop(task)) {
+                        finish(task.index, task.snapshot);
+                    }
+                });
+            }
+        }
+
+        // Dispatcher (this thread)
+        const auto start = std::chrono::steady_clock::now();
+        const double ticks_per_record = rate > 0 ? cycles_per_ns() * 1e9 / rate : 0.0;
+        const std::uint64_t first_tick = cycle_now();
+        for (std::uint32_t index = 0; index < flow.size(); ++index) {
+            if (ticks_per_record > 0) {
+                const auto due = first_tick + static_cast<std::uint64_t>(index * ticks_per_record);
+                while (cycle_now() < due) {
+                }
+            }
+            const std::size_t target = mode == "sharded" ?
+                (flow[index].instrument_id - config.first_instrument_id) % threads : 0;
+            dispatched[index] = cycle_now();
+            inputs[target]->push(std::uint32_t{index});
+        }
+        for (auto& input : inputs) {
+            input->push(std::uint32_t{END_OF_STREAM});
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const double wall = seconds_since(start);
+
+        LatencyRecorder recorder;
+        recorder.reserve(latency.size());
+        for (auto sample : latency) {
+            recorder.record(sample);
+        }
+
+        Result result;
+        result.throughput = flow.size() / wall;
+        result.latency = recorder.summarize();
+        return result;
+    }
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --instruments K,K,...  Instrument counts (default 1,10,100,1000,10000)\n"
+              << "  --threads T,T,...      Worker thread counts (default powers of two up to the core count)\n"
+              << "  --modes M,M            sharded,pipelined (default both)\n"
+              << "  --records N            Timed records per configuration (default 1000000)\n"
+              << "  --resting N            Resting orders across all instruments (default 100000)\n"
+              << "  --rate R               Offered records/s, 0 = saturate (default 0)\n"
+              << "  --queue N              Queue capacity per thread (default 4096)\n"
+              << "  --seed S               Generator seed (default 42)\n"
+              << "  --json FILE            Write results as JSON\n";
+}
+
+std::vector<std::size_t> parse_counts(const std::string& value) {
+    std::vector<std::size_t> counts;
+    for (const auto& item : orderbook::benchmark::split_list(value)) {
+        const std::size_t count = std::stoull(item);
+        if (count == 0) {
+            throw std::invalid_argument("counts must be positive");
+        }
+        counts.push_back(count);
+    }
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    orderbook::benchmark::ScalingBenchmark bench;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--instruments") {
+            bench.instrument_counts = parse_counts(value);
+        } else if (arg == "--threads") {
+            bench.thread_counts = parse_counts(value);
+        } else if (arg == "--modes") {
+            bench.modes = orderbook::benchmark::split_list(value);
+            for (const auto& mode : bench.modes) {
+                if (mode != "sharded" && mode != "pipelined") {
+                    print_usage(argv[0]);
+                    return 1;
+                }
+            }
+        } else if (arg == "--records") {
+            bench.records = std::stoull(value);
+        } else if (arg == "--resting") {
+            bench.resting_orders = std::stoull(value);
+        } else if (arg == "--rate") {
+            bench.rate = std::stod(value);
+        } else if (arg == "--queue") {
+            bench.queue_capacity = std::stoull(value);
+        } else if (arg == "--seed") {
+            bench.seed = std::stoull(value);
+        } else if (arg == "--json") {
+            bench.json_output = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    return bench.run();
+}
@@ -0,0 +1,472 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include "bench_common.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <malloc.h>
+#endif
+
+// Startup and warm-up benchmark.
+//
+// Each run re-executes this binary as a fresh process that replays a
+// generated file through parse -> book -> MBP snapshot -> CSV row -> output
+// stream. The child reports, relative to the parent's spawn time: time to
+// main, time to the first emitted row, minor/major page faults over the
+// first million records, and throughput during the first second versus the
+// steady state (last half of the file). Start modes:
+//
+//   plain      nothing done up front
+//   prefault   heap pages touched (and kept by malloc) before the replay
+//   reserve    Orderbook::reserve with the expected resting orders and a
+//              1 MB output buffer
+//   prefault+reserve
+
+namespace orderbook {
+namespace benchmark {
+
+namespace fs = std::filesystem;
+
+std::int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct FaultCounts {
+    long minor = 0;
+    long major = 0;
+};
+
+FaultCounts fault_counts() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return {usage.ru_minflt, usage.ru_majflt};
+}
+
+// ---------------------------------------------------------------------------
+// Child: one replay in a fresh process, reports "key value" lines on stdout
+
+struct ChildOptions {
+    std::string input;
+    std::string output;
+    std::string mode;
+    std::int64_t spawn_ns = 0;
+    std::size_t expected_orders = 0;
+    std::size_t prefault_mb = 256;
+    std::size_t fault_window = 1000000;
+    std::size_t sample_every = 8192;
+};
+
+int run_child(const ChildOptions& options) {
+    const std::int64_t main_ns = monotonic_ns();
+    const FaultCounts at_main = fault_counts();
+
+    const bool prefault = options.mode.find("prefault") != std::string::npos;
+    const bool reserve = options.mode.find("reserve") != std::string::npos;
+
+    if (prefault) {
+#ifdef __linux__
+        // Serve large blocks from the heap and never return freed pages,
+        // so the touched pages are reused by the replay
+        mallopt(M_MMAP_THRESHOLD, 512 * 1024 * 1024);
+        mallopt(M_TRIM_THRESHOLD, -1);
+#endif
+        const std::size_t bytes = options.prefault_mb << 20;
+        char* block = static_cast<char*>(std::malloc(bytes));
+        if (block) {
+            const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            for (std::size_t offset = 0; offset < bytes; offset += page) {
+                block[offset] = 1;
+            }
+            do_not_optimize(block[bytes - 1]);
+            std::free(block);
+        }
+    }
+
+    Orderbook orderbook;
+    std::vector<char> output_buffer;
+    std::ofstream output;
+    if (reserve) {
+        orderbook.reserve(options.expected_orders);
+        output_buffer.resize(1 << 20);
+        output.rdbuf()->pubsetbuf(output_buffer.data(), static_cast<std::streamsize>(output_buffer.size()));
+    }
+    output.open(options.output, std::ios::binary | std::ios::trunc);
+    std::ifstream input(options.input);
+    if (!input.is_open() || !output.is_open()) {
+        std::cerr << "child: cannot open input or output\n";
+        return 1;
+    }
+
+    const std::int64_t replay_ns = monotonic_ns();
+    const FaultCounts at_replay = fault_counts();
+    FaultCounts at_window = at_replay;
+    std::int64_t first_row_ns = 0;
+    std::int64_t window_ns = 0;
+    std::vector<std::pair<std::size_t, std::int64_t>> samples;
+
+    std::string line;
+    std::getline(input, line);  // Header
+    std::size_t records = 0;
+    while (std::getline(input, line)) {
+        auto record = CSVParser::parse_mbo_line(line);
+        if (!record) {
+            continue;
+        }
+        orderbook.process_mbo_record(*record);
+        output << CSVParser::format_mbp_record(orderbook.generate_mbp_record(*record)) << '\n';
+        ++records;
+
+        if (records == 1) {
+            first_row_ns = monotonic_ns();
+        }
+        if (records % options.sample_every == 0) {
+            samples.emplace_back(records, monotonic_ns() - replay_ns);
+        }
+        if (records == options.fault_window) {
+            at_window = fault_counts();
+            window_ns = monotonic_ns();
+        }
+    }
+    output.flush();
+    const std::int64_t end_ns = monotonic_ns();
+    if (records < options.fault_window) {
+        at_window = fault_counts();
+        window_ns = end_ns;
+    }
+    samples.emplace_back(records, end_ns - replay_ns);
+
+    std::cout << "records " << records << "\n"
+              << "to_main_ns " << main_ns - options.spawn_ns << "\n"
+              << "setup_ns " << replay_ns - main_ns << "\n"
+              << "to_first_row_ns " << first_row_ns - options.spawn_ns << "\n"
+              << "replay_ns " << end_ns - replay_ns << "\n"
+              << "window_records " << std::min(records, options.fault_window) << "\n"
+              << "window_ns " << window_ns - replay_ns << "\n"
+              << "startup_minor_faults " << at_replay.minor << "\n"
+              << "startup_major_faults " << at_replay.major << "\n"
+              << "exec_minor_faults " << at_main.minor << "\n"
+              << "window_minor_faults " << at_window.minor - at_replay.minor << "\n"
+              << "window_major_faults " << at_window.major - at_replay.major << "\n"
+              << "peak_rss_kb " << peak_rss_kb() << "\n";
+    for (const auto& [count, ns] : samples) {
+        std::cout << "sample " << count << " " << ns << "\n";
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Parent: generates the input, spawns one child per mode and repetition
+
+struct StartupResult {
+    std::vector<std::pair<std::string, double>> values;
+    std::vector<std::pair<std::size_t, std::int64_t>> samples;
+
+    double get(const std::string& key) const {
+        for (const auto& [name, value] : values) {
+            if (name == key) {
+                return value;
+            }
+        }
+        return 0.0;
+    }
+};
+
+class StartupBenchmark {
+public:
+    std::size_t records = 1000000;
+    std::size_t resting_orders = 100000;
+    std::vector<std::string> modes = {"plain", "prefault", "reserve", "prefault+reserve"};
+    std::size_t repeat = 1;
+    std::size_t prefault_mb = 256;
+    std::uint64_t seed = 42;
+    std::string work_dir = fs::temp_directory_path().string();
+    std::string json_output;
+    std::string self;
+
+    int run() {
+        std::cout << "Startup and Warm-up Benchmark\n";
+        std::cout << "=============================\n";
+
+        const std::string input = generate_input();
+        const std::string output = (fs::path(work_dir) / ("mbp_startup_" + std::to_string(getpid()) + ".csv")).string();
+
+        std::cout << "\n" << std::left << std::setw(18) << "Mode" << std::right
+                  << std::setw(10) << "main ms" << std::setw(10) << "setup ms" << std::setw(12) << "1st row ms"
+                  << std::setw(10) << "minflt" << std::setw(8) << "majflt"
+                  << std::setw(12) << "1st s r/s" << std::setw(12) << "steady r/s" << "\n";
+        std::cout << std::string(92, '-') << "\n";
+
+        std::vector<std::string> results;
+        for (const auto& mode : modes) {
+            for (std::size_t r = 0; r < repeat; ++r) {
+                prewarm(input);  // Same page-cache state for every mode
+                StartupResult result;
+                if (!spawn(mode, input, output, result)) {
+                    std::cerr << "  run failed (" << mode << ")\n";
+                    fs::remove(input);
+                    fs::remove(output);
+                    return 1;
+                }
+                results.push_back(report(mode, r, result));
+            }
+        }
+
+        fs::remove(input);
+        fs::remove(output);
+
+        if (!json_output.empty()) {
+            const std::string json = JsonObject()
+                .add("benchmark", "startup")
+                .add("timestamp", utc_timestamp())
+                .add("seed", seed)
+                .add("records", records)
+                .add("resting_orders", resting_orders)
+                .add("prefault_mb", prefault_mb)
+                .add_raw("results", json_array(results))
+                .str();
+            if (!write_text_file(json_output, json + "\n")) {
+                std::cerr << "Cannot write " << json_output << "\n";
+                return 1;
+            }
+            std::cout << "\nResults written to: " << json_output << "\n";
+        }
+        return 0;
+    }
+
+private:
+    std::string generate_input() {
+        const fs::path path = fs::path(work_dir) / ("mbo_startup_" + std::to_string(getpid()) + ".csv");
+        std::cout << "Generating " << records << " records (" << resting_orders
+                  << " resting orders built at the open) -> " << path.string() << "\n";
+
+        MarketGeneratorConfig config;
+        config.seed = seed;
+        config.initial_depth = resting_orders;
+        config.target_resting_orders = resting_orders;
+        MarketGenerator generator(config);
+
+        std::vector<char> buffer(1 << 20);
+        std::ofstream output;
+        output.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        output.open(path);
+        generator.write_csv(output, records);
+        return path.string();
+    }
+
+    static void prewarm(const std::string& path) {
+        std::ifstream input(path, std::ios::binary);
+        std::vector<char> buffer(1 << 20);
+        while (input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0) {
+        }
+    }
+
+    bool spawn(const std::string& mode, const std::string& input, const std::string& output, StartupResult& result) {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            return false;
+        }
+        std::cout.flush();
+
+        const std::vector<std::string> args = {
+            self, "--child", mode, "--input", input, "--output", output,
+            "--expected-orders", std::to_string(resting_orders),
+            "--prefault-mb", std::to_string(prefault_mb),
+            "--spawn-ns", std::to_string(monotonic_ns()),
+        };
+
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(fds[0]);
+            ::dup2(fds[1], STDOUT_FILENO);
+            ::close(fds[1]);
+            std::vector<char*> argv;
+            for (const auto& arg : args) {
+                argv.push_back(const_cast<char*>(arg.c_str()));
+            }
+            argv.push_back(nullptr);
+            ::execv(self.c_str(), argv.data());
+            ::_exit(127);
+        }
+        ::close(fds[1]);
+        if (pid < 0) {
+            ::close(fds[0]);
+            return false;
+        }
+
+        std::string text;
+        char buffer[4096];
+        ssize_t n = 0;
+        while ((n = ::read(fds[0], buffer, sizeof(buffer))) > 0) {
+            text.append(buffer, static_cast<std::size_t>(n));
+        }
+        ::close(fds[0]);
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            return false;
+        }
+
+        std::istringstream lines(text);
+        std::string key;
+        while (lines >> key) {
+            if (key == "sample") {
+                std::size_t count = 0;
+                std::int64_t ns = 0;
+                lines >> count >> ns;
+                result.samples.emplace_back(count, ns);
+            } else {
+                double value = 0.0;
+                lines >> value;
+                result.values.emplace_back(key, value);
+            }
+        }
+        return !result.samples.empty();
+    }
+
+    std::string report(const std::string& mode, std::size_t repetition, const StartupResult& result) {
+        // Throughput during the first second of the replay
+        double first_second = 0.0;
+        for (const auto& [count, ns] : result.samples) {
+            if (ns > 1000000000) {
+                break;
+            }
+            first_second = count / (ns / 1e9);
+        }
+
+        // Steady state: second half of the records
+        const auto& last = result.samples.back();
+        double steady = 0.0;
+        for (const auto& [count, ns] : result.samples) {
+            if (count * 2 >= last.first && last.second > ns) {
+                steady = (last.first - count) / ((last.second - ns) / 1e9);
+                break;
+            }
+        }
+
+        std::cout << std::left << std::setw(18) << mode << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << result.get("to_main_ns") / 1e6
+                  << std::setw(10) << result.get("setup_ns") / 1e6
+                  << std::setw(12) << result.get("to_first_row_ns") / 1e6
+                  << std::setprecision(0) << std::setw(10) << result.get("window_minor_faults")
+                  << std::setw(8) << result.get("window_major_faults")
+                  << std::setw(12) << first_second << std::setw(12) << steady << "\n";
+
+        JsonObject json;
+        json.add("mode", mode).add("repetition", repetition);
+        for (const auto& [name, value] : result.values) {
+            json.add(name, value);
+        }
+        json.add("first_second_records_per_second", first_second)
+            .add("steady_records_per_second", steady);
+
+        std::vector<std::string> samples;
+        for (const auto& [count, ns] : result.samples) {
+            samples.push_back("[" + std::to_string(count) + ", " + std::to_string(ns) + "]");
+        }
+        std::string series = "[";
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            series += (i ? ", " : "") + samples[i];
+        }
+        json.add_raw("samples_records_ns", series + "]");
+        return json.str();
+    }
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --records N       Records in the generated session (default 1000000)\n"
+              << "  --resting N       Resting orders built at the open (default 100000)\n"
+              << "  --modes M,M,...   plain,prefault,reserve,prefault+reserve (default all)\n"
+              << "  --repeat R        Runs per mode (default 1)\n"
+              << "  --prefault-mb MB  Heap prefaulted in prefault modes (default 256)\n"
+              << "  --dir PATH        Directory for generated files (default system temp)\n"
+              << "  --seed S          Generator seed (default 42)\n"
+              << "  --json FILE       Write results as JSON\n";
+}
+
+std::string self_path(const char* argv0) {
+#ifdef __linux__
+    std::error_code error;
+    const auto path = std::filesystem::read_symlink("/proc/self/exe", error);
+    if (!error) {
+        return path.string();
+    }
+#endif
+    return argv0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace orderbook::benchmark;
+
+    if (argc > 2 && std::string(argv[1]) == "--child") {
+        ChildOptions options;
+        options.mode = argv[2];
+        for (int i = 3; i + 1 < argc; i += 2) {
+            const std::string arg = argv[i];
+            const std::string value = argv[i + 1];
+            if (arg == "--input") {
+                options.input = value;
+            } else if (arg == "--output") {
+                options.output = value;
+            } else if (arg == "--expected-orders") {
+                options.expected_orders = std::stoull(value);
+            } else if (arg == "--prefault-mb") {
+                options.prefault_mb = std::stoull(value);
+            } else if (arg == "--spawn-ns") {
+                options.spawn_ns = std::stoll(value);
+            }
+        }
+        return run_child(options);
+    }
+
+    StartupBenchmark bench;
+    bench.self = self_path(argv[0]);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--records") {
+            bench.records = std::stoull(value);
+        } else if (arg == "--resting") {
+            bench.resting_orders = std::stoull(value);
+        } else if (arg == "--modes") {
+            bench.modes = split_list(value);
+        } else if (arg == "--repeat") {
+            bench.repeat = std::stoull(value);
+        } else if (arg == "--prefault-mb") {
+            bench.prefault_mb = std::stoull(value);
+        } else if (arg == "--dir") {
+            bench.work_dir = value;
+        } else if (arg == "--seed") {
+            bench.seed = std::stoull(value);
+        } else if (arg == "--json") {
+            bench.json_output = value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    return bench.run();
+}
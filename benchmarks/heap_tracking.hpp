@@ -0,0 +1,109 @@
+#pragma once
+
+// Global allocator that counts live heap bytes, for bytes-per-order figures.
+//
+// Replaces the global operator new/delete, so include it from exactly one
+// translation unit of a benchmark executable. Allocations are only counted
+// while tracking is enabled; a book's frees happen inside the same tracked
+// calls (or its destructor), so unrelated allocations by the generator or
+// the harness stay out of the total.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace orderbook {
+namespace benchmark {
+
+namespace heap_detail {
+
+inline std::atomic<std::int64_t> live_bytes{0};
+inline thread_local bool tracking = true;
+
+inline std::size_t allocation_size(void* ptr) noexcept {
+#ifdef __APPLE__
+    return malloc_size(ptr);
+#else
+    return malloc_usable_size(ptr);
+#endif
+}
+
+inline void* tracked_alloc(std::size_t size, std::size_t alignment) {
+    void* ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(size == 0 ? 1 : size);
+    } else if (posix_memalign(&ptr, alignment, size == 0 ? alignment : size) != 0) {
+        ptr = nullptr;
+    }
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    if (tracking) {
+        live_bytes.fetch_add(static_cast<std::int64_t>(allocation_size(ptr)), std::memory_order_relaxed);
+    }
+    return ptr;
+}
+
+inline void tracked_free(void* ptr) noexcept {
+    if (ptr) {
+        if (tracking) {
+            live_bytes.fetch_sub(static_cast<std::int64_t>(allocation_size(ptr)), std::memory_order_relaxed);
+        }
+        std::free(ptr);
+    }
+}
+
+} // namespace heap_detail
+
+// Live heap bytes allocated while tracking was enabled
+inline std::int64_t tracked_heap_bytes() noexcept {
+    return heap_detail::live_bytes.load(std::memory_order_relaxed);
+}
+
+// Enable or disable counting on the calling thread (enabled by default)
+inline void set_heap_tracking(bool enabled) noexcept {
+    heap_detail::tracking = enabled;
+}
+
+// Disables counting on the calling thread for the lifetime of the guard
+class UntrackedHeapScope {
+public:
+    UntrackedHeapScope() noexcept : previous_(heap_detail::tracking) { heap_detail::tracking = false; }
+    ~UntrackedHeapScope() { heap_detail::tracking = previous_; }
+    UntrackedHeapScope(const UntrackedHeapScope&) = delete;
+    UntrackedHeapScope& operator=(const UntrackedHeapScope&) = delete;
+
+private:
+    bool previous_;
+};
+
+} // namespace benchmark
+} // namespace orderbook
+
+void* operator new(std::size_t size) {
+    return orderbook::benchmark::heap_detail::tracked_alloc(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size) {
+    return orderbook::benchmark::heap_detail::tracked_alloc(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t align) {
+    return orderbook::benchmark::heap_detail::tracked_alloc(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return orderbook::benchmark::heap_detail::tracked_alloc(size, static_cast<std::size_t>(align));
+}
+void operator delete(void* ptr) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { orderbook::benchmark::heap_detail::tracked_free(ptr); }
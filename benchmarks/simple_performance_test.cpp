@@ -1,9 +1,11 @@
 #include "orderbook.hpp"
+#include "market_generator.hpp"
 #include <iostream>
 #include <chrono>
-#include <random>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
+#include <random>
 
 namespace orderbook {
 namespace benchmark {
@@ -33,41 +35,29 @@ public:
     }
     
 private:
+    // Realistic add/cancel/trade flow
+    static MarketGeneratorConfig flow_config() {
+        MarketGeneratorConfig config;
+        config.seed = 20250717;
+        return config;
+    }
+    
+    // Add-only flow for the add/cancel tests
+    static MarketGeneratorConfig add_only_config() {
+        MarketGeneratorConfig config = flow_config();
+        config.cancel_to_add_ratio = 0.0;
+        config.trade_probability = 0.0;
+        return config;
+    }
+    
     static void test_order_processing_throughput() {
         std::cout << "1. Order Processing Throughput Test\n";
         std::cout << "-----------------------------------\n";
         
         const std::size_t num_orders = 100000;
-        std::vector<MBORecord> test_records;
-        test_records.reserve(num_orders);
-        
-        // Generate test data
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<price_t> price_dist(900000, 1100000);
-        std::uniform_int_distribution<size_t> size_dist(1, 1000);
-        std::uniform_int_distribution<order_id_t> id_dist(1, 1000000);
-        
-        for (std::size_t i = 0; i < num_orders; ++i) {
-            MBORecord record;
-            record.timestamp.ts_recv = i * 1000;
-            record.timestamp.ts_event = i * 1000;
-            record.rtype = RecordType::MBO;
-            record.publisher_id = 2;
-            record.instrument_id = 1108;
-            record.action = (i % 3 == 0) ? Action::ADD : Action::CANCEL;
-            record.side = (i % 2 == 0) ? Side::BID : Side::ASK;
-            record.price = price_dist(gen);
-            record.size = size_dist(gen);
-            record.order_id = id_dist(gen);
-            record.symbol = "PERF";
-            record.channel_id = 1;
-            record.flags = 0;
-            record.ts_in_delta = 0;
-            record.sequence = i;
-            
-            test_records.push_back(record);
-        }
+        // Generate test data (realistic add/cancel/trade flow)
+        MarketGenerator generator(flow_config());
+        const std::vector<MBORecord> test_records = generator.generate(num_orders);
         
         // Run benchmark
         Orderbook orderbook;
@@ -98,27 +88,13 @@ private:
         
         // Pre-populate orderbook
         Orderbook orderbook;
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<price_t> price_dist(900000, 1100000);
-        std::uniform_int_distribution<size_t> size_dist(1, 1000);
-        std::uniform_int_distribution<order_id_t> id_dist(1, 1000000);
-        
-        for (std::size_t i = 0; i < 1000; ++i) {
-            MBORecord record;
-            record.action = Action::ADD;
-            record.side = (i % 2 == 0) ? Side::BID : Side::ASK;
-            record.price = price_dist(gen);
-            record.size = size_dist(gen);
-            record.order_id = id_dist(gen);
-            record.symbol = "PERF";
-            
+        MarketGenerator generator(add_only_config());
+        for (const auto& record : generator.generate(1000)) {
             orderbook.process_mbo_record(record);
         }
         
         // Create a sample record for MBP generation
-        MBORecord sample_record;
-        sample_record.symbol = "PERF";
+        MBORecord sample_record = generator.next();
         
         // Run benchmark
         auto start_time = std::chrono::high_resolution_clock::now();
@@ -147,23 +123,12 @@ private:
         const std::size_t num_orders = 100000;
         
         Orderbook orderbook;
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<price_t> price_dist(900000, 1100000);
-        std::uniform_int_distribution<size_t> size_dist(1, 1000);
-        std::uniform_int_distribution<order_id_t> id_dist(1, 1000000);
+        MarketGenerator generator(add_only_config());
+        const std::vector<MBORecord> adds = generator.generate(num_orders);
         
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        for (std::size_t i = 0; i < num_orders; ++i) {
-            MBORecord record;
-            record.action = Action::ADD;
-            record.side = Side::BID;
-            record.price = price_dist(gen);
-            record.size = size_dist(gen);
-            record.order_id = id_dist(gen);
-            record.symbol = "PERF";
-            
+        for (const auto& record : adds) {
             orderbook.process_mbo_record(record);
         }
         
@@ -188,36 +153,24 @@ private:
         
         // Pre-populate with orders
         Orderbook orderbook;
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<price_t> price_dist(900000, 1100000);
-        std::uniform_int_distribution<size_t> size_dist(1, 1000);
-        
-        for (std::size_t i = 0; i < 10000; ++i) {
-            MBORecord add_record;
-            add_record.action = Action::ADD;
-            add_record.side = Side::BID;
-            add_record.price = price_dist(gen);
-            add_record.size = size_dist(gen);
-            add_record.order_id = i + 1;
-            add_record.symbol = "PERF";
-            
-            orderbook.process_mbo_record(add_record);
+        MarketGenerator generator(add_only_config());
+        const std::vector<MBORecord> adds = generator.generate(10000);
+        for (const auto& record : adds) {
+            orderbook.process_mbo_record(record);
         }
         
+        // Cancel resting orders in a deterministic shuffled order
+        std::vector<MBORecord> cancels(adds.begin(), adds.begin() + num_cancels);
+        for (auto& cancel : cancels) {
+            cancel.action = Action::CANCEL;
+        }
+        std::shuffle(cancels.begin(), cancels.end(), std::mt19937_64(7));
+        
         // Run cancel benchmark
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        for (std::size_t i = 0; i < num_cancels; ++i) {
-            MBORecord cancel_record;
-            cancel_record.action = Action::CANCEL;
-            cancel_record.side = Side::BID;
-            cancel_record.price = price_dist(gen);
-            cancel_record.size = size_dist(gen);
-            cancel_record.order_id = (i % 10000) + 1;
-            cancel_record.symbol = "PERF";
-            
-            orderbook.process_mbo_record(cancel_record);
+        for (const auto& record : cancels) {
+            orderbook.process_mbo_record(record);
         }
         
         auto end_time = std::chrono::high_resolution_clock::now();
@@ -240,23 +193,12 @@ private:
         const std::size_t num_orders = 50000;
         
         Orderbook orderbook;
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<price_t> price_dist(900000, 1100000);
-        std::uniform_int_distribution<size_t> size_dist(1, 1000);
-        std::uniform_int_distribution<order_id_t> id_dist(1, 1000000);
+        MarketGenerator generator(add_only_config());
+        const std::vector<MBORecord> adds = generator.generate(num_orders);
         
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        for (std::size_t i = 0; i < num_orders; ++i) {
-            MBORecord record;
-            record.action = Action::ADD;
-            record.side = (i % 2 == 0) ? Side::BID : Side::ASK;
-            record.price = 1000000 + (i % 100) * 1000;
-            record.size = 100;
-            record.order_id = i + 1;
-            record.symbol = "MEM";
-            
+        for (const auto& record : adds) {
             orderbook.process_mbo_record(record);
         }
         
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+// Resting order as reported by an engine lookup
+struct OrderView {
+    Side side;
+    price_t price;
+    size_t size;
+};
+
+// Common interface for book implementations.
+//
+// Every engine applies the same MBO records and must report identical
+// top-of-book levels (bids best-first descending, asks best-first
+// ascending) and order lookups. The benchmark matrix and the differential
+// harness drive engines exclusively through this interface.
+class BookEngine {
+public:
+    virtual ~BookEngine() = default;
+
+    // Apply one MBO record to the book
+    virtual void apply(const MBORecord& record) = 0;
+
+    // Top MAX_DEPTH levels of one side, best first, empty levels zeroed
+    virtual std::array<PriceLevel, MAX_DEPTH> top_levels(Side side) const = 0;
+
+    // Resting order lookup
+    virtual std::optional<OrderView> find_order(order_id_t order_id) const = 0;
+
+    // Resting orders on both sides
+    virtual std::size_t order_count() const noexcept = 0;
+};
+
+using BookEngineFactory = std::function<std::unique_ptr<BookEngine>()>;
+
+struct BookEngineInfo {
+    std::string name;
+    std::string description;
+    BookEngineFactory create;
+};
+
+// Engine registry. Built-in engines are registered in book_engine.cpp;
+// experimental engines can be added at runtime before running a matrix.
+void register_book_engine(std::string name, std::string description, BookEngineFactory factory);
+const std::vector<BookEngineInfo>& registered_book_engines();
+std::unique_ptr<BookEngine> create_book_engine(const std::string& name);
+
+} // namespace orderbook
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "orderbook.hpp"
+#include "replay_index.hpp"
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+// Point-in-time book queries over an indexed MBO file.
+//
+// Queries are by capture order: t is a ts_event, and the book at t is the
+// state after every record in file (ts_recv) order before the first record
+// with ts_event > t, the same cut the index and process_window use. ts_event
+// is not monotonic in a capture, so a later record with ts_event <= t (sent
+// earlier but received after the cut) is not part of that book.
+//
+// A query starts from the latest usable state: a cached book already at or
+// before t, or the nearest index checkpoint before t, whichever is further
+// along. It then replays the tail without snapshots or formatting.
+//
+// The cache holds the most recently used book states (LRU). A state is a
+// cursor: answering a later time advances it in place. So a forward scan
+// over a day replays each record once, and repeating a time costs no replay.
+
+struct BookSnapshot {
+    timestamp_t ts_event = 0;       // Requested time
+    CheckpointPosition position;    // Last record applied; byte_offset is the next one
+    std::vector<BookLevel> bids;    // Best first
+    std::vector<BookLevel> asks;
+};
+
+struct BookQueryStats {
+    std::size_t queries = 0;
+    std::size_t cache_hits = 0;        // Started from a cached state
+    std::size_t checkpoint_loads = 0;
+    std::uint64_t records_replayed = 0;
+};
+
+class BookQuery {
+public:
+    // Throws std::runtime_error if the index was built for a different
+    // version of the file. The file must not change while the query is open.
+    BookQuery(std::string input_file, ReplayIndex index, std::size_t cache_states = 8);
+
+    // Uses the default sidecar index (<input>.idx)
+    explicit BookQuery(const std::string& input_file, std::size_t cache_states = 8);
+
+    // Levels best-first up to depth (0 = every level); L3 adds each level's orders
+    BookSnapshot book_at(timestamp_t ts, std::size_t depth = MAX_DEPTH, bool orders = false);
+
+    const BookQueryStats& stats() const noexcept { return stats_; }
+    const ReplayIndex& index() const noexcept { return index_; }
+
+private:
+    struct CachedState {
+        std::unique_ptr<Orderbook> book;
+        CheckpointPosition position;
+        timestamp_t max_applied;   // Upper bound on the ts_event of every applied record
+        timestamp_t next_ts;       // ts_event of the next record (max at end of file, min if unknown)
+    };
+
+    std::string input_file_;
+    ReplayIndex index_;
+    std::size_t cache_states_;
+    std::list<CachedState> cache_;  // Most recently used first
+    std::ifstream input_;
+    BookQueryStats stats_;
+
+    std::list<CachedState>::iterator start_state(timestamp_t ts);
+    void replay_to(CachedState& state, timestamp_t ts);
+};
+
+// One-shot form of BookQuery::book_at. Keeps one BookQuery (and its cache)
+// per input file, reopened when the file's size or modification time
+// changes; safe to call from any thread. Throws std::runtime_error if the
+// file is missing or its index is stale.
+BookSnapshot book_at(const std::string& input_file, timestamp_t ts, std::size_t depth = MAX_DEPTH,
+                     bool orders = false);
+
+} // namespace orderbook
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "orderbook.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+// Chain of restore points: a full book image every `full_every` saves and
+// delta checkpoints (only what changed since the previous save) in between.
+//
+// Files are <prefix>.<serial>.full and <prefix>.<serial>.delta with serials
+// increasing. A restore point is rebuilt from the nearest full image at or
+// before it plus the deltas after that image, in order. compact() folds the
+// older points into one full image so the chain's disk use stays bounded.
+
+struct RestorePoint {
+    std::uint64_t serial = 0;
+    bool full = false;
+    CheckpointPosition position;
+    std::string path;
+};
+
+class CheckpointChain {
+public:
+    // Picks up the restore points already on disk under the prefix
+    explicit CheckpointChain(std::string prefix, std::size_t full_every = 16);
+
+    // Saves the book as a new restore point. A full image is written for the
+    // first save, every full_every-th save, and whenever the book's tracked
+    // changes are not relative to this chain's newest point; the book is left
+    // tracking changes so the next save can be a delta.
+    const RestorePoint& save(Orderbook& book, const CheckpointPosition& position);
+
+    // Loads restore point `point` into the book. Restoring the newest point
+    // leaves the book tracking changes, so saving can continue the chain.
+    CheckpointPosition restore(Orderbook& book, std::size_t point);
+    CheckpointPosition restore_latest(Orderbook& book);
+
+    // Keeps the newest `keep` restore points (at least one): the oldest kept
+    // point becomes a full image and every file before it is deleted
+    void compact(std::size_t keep);
+
+    const std::vector<RestorePoint>& points() const noexcept { return points_; }
+    const std::string& prefix() const noexcept { return prefix_; }
+    std::uint64_t disk_bytes() const;
+
+private:
+    std::string prefix_;
+    std::size_t full_every_;
+    std::vector<RestorePoint> points_;
+    const Orderbook* tracked_ = nullptr;  // Book whose changes are relative to points_.back()
+
+    std::string path_for(std::uint64_t serial, bool full) const;
+    std::size_t base_of(std::size_t point) const;
+    CheckpointPosition rebuild(Orderbook& book, std::size_t point) const;
+};
+
+} // namespace orderbook
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "types.hpp"
+#include "book_engine.hpp"
+#include "line_parser.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+// Differential testing of optimized parsers and book engines.
+//
+// Candidates are run side by side with a reference on generated and fuzzed
+// input. Any difference in parsed records, accept/reject decisions, top-N
+// levels, order lookups or order counts is a mismatch; the failing input is
+// then shrunk with delta debugging so the report shows a minimal case.
+
+// Field-by-field comparison; returns a description of the first difference
+std::optional<std::string> diff_records(const MBORecord& expected, const MBORecord& actual);
+
+// Runs both parsers on one line (a thrown exception counts as an outcome)
+std::optional<std::string> diff_parse(const LineParserInfo& reference, const LineParserInfo& candidate,
+                                      const std::string& line);
+
+// Replays a record stream into fresh engines, comparing state after every record
+std::optional<std::string> diff_books(const BookEngineFactory& reference, const BookEngineFactory& candidate,
+                                      const std::vector<MBORecord>& records);
+
+// Delta debugging (ddmin): smallest subsequence for which still_fails holds
+template<typename T>
+std::vector<T> minimize(std::vector<T> input, const std::function<bool(const std::vector<T>&)>& still_fails) {
+    std::size_t granularity = 2;
+    while (input.size() >= 2) {
+        const std::size_t chunk = (input.size() + granularity - 1) / granularity;
+        bool reduced = false;
+        for (std::size_t begin = 0; begin < input.size(); begin += chunk) {
+            // Try the complement of each chunk
+            const std::size_t end = std::min(begin + chunk, input.size());
+            std::vector<T> complement;
+            complement.reserve(input.size() - (end - begin));
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                if (i < begin || i >= end) {
+                    complement.push_back(input[i]);
+                }
+            }
+            if (!complement.empty() && still_fails(complement)) {
+                input = std::move(complement);
+                granularity = std::max<std::size_t>(granularity - 1, 2);
+                reduced = true;
+                break;
+            }
+        }
+        if (!reduced) {
+            if (granularity >= input.size()) {
+                break;
+            }
+            granularity = std::min(granularity * 2, input.size());
+        }
+    }
+    return input;
+}
+
+std::string minimize_line(const std::string& line, const std::function<bool(const std::string&)>& still_fails);
+
+// Deterministic mutations of valid MBO lines and record streams
+class MboFuzzer {
+public:
+    explicit MboFuzzer(std::uint64_t seed) : rng_(seed) {}
+
+    // Applies 1..max_mutations byte- and field-level edits
+    std::string mutate_line(const std::string& line, std::size_t max_mutations = 3);
+
+    // Duplicates, drops, reorders and corrupts records (unknown ids, zero
+    // sizes, oversize cancels, neutral sides)
+    std::vector<MBORecord> mutate_stream(std::vector<MBORecord> records, double mutation_rate = 0.05);
+
+private:
+    std::mt19937_64 rng_;
+
+    std::size_t below(std::size_t bound) { return bound ? rng_() % bound : 0; }
+};
+
+struct DifferentialConfig {
+    std::uint64_t seed = 1;
+    std::size_t lines = 100000;            // Generated lines, each also fuzzed
+    std::size_t streams = 200;             // Record streams per engine
+    std::size_t stream_length = 2000;
+    std::vector<std::string> parsers;      // Candidates (default: all but the reference)
+    std::vector<std::string> engines;      // Candidates (default: all but the reference)
+    std::size_t max_failures = 10;         // Stop collecting after this many
+};
+
+struct DifferentialFailure {
+    std::string kind;                      // "parser" or "engine"
+    std::string candidate;
+    std::string detail;
+    std::string input;                     // Minimized line, or CSV of the minimized stream
+    std::size_t original_size = 0;         // Bytes or records before minimization
+    std::size_t minimized_size = 0;
+};
+
+struct DifferentialReport {
+    std::size_t parser_cases = 0;
+    std::size_t engine_streams = 0;
+    std::size_t engine_records = 0;
+    std::vector<DifferentialFailure> failures;
+
+    bool passed() const noexcept { return failures.empty(); }
+};
+
+// Checks candidates against the first registered parser and engine
+DifferentialReport run_differential(const DifferentialConfig& config);
+
+// Same, with explicit reference and candidates (used by the unit tests)
+DifferentialReport run_differential(const DifferentialConfig& config,
+                                    const LineParserInfo& reference_parser,
+                                    const std::vector<LineParserInfo>& candidate_parsers,
+                                    const BookEngineInfo& reference_engine,
+                                    const std::vector<BookEngineInfo>& candidate_engines);
+
+} // namespace orderbook
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace orderbook {
+
+// A/B arbitration of two redundant MBO lines carrying the same channels.
+//
+// Both lines are read in step and merged on ts_recv, the order the records
+// arrived in (on a tie, the lower sequence of a channel, then line A). A
+// channel is a (publisher_id, channel_id) key, as in SequenceTracker. The
+// first arrival of each (channel, sequence) is delivered and the other
+// line's copy is dropped, so a record one line lost is still delivered from
+// the other, and the book sees every sequence once. Records that share a
+// sequence (one venue message can produce several) are delivered together
+// from the line that won it.
+//
+// Unsequenced records (sequence 0, e.g. a clear) have no sequence to match
+// on, so the lines' copies are matched by content: ts_event, action, side,
+// price, size, order id, flags and instrument. The n-th copy of a record is
+// delivered from whichever line reads its n-th copy first.
+//
+// A record that arrives after a gap in its channel is held, with every
+// later record of the channel, until the missing sequence arrives from
+// either line; the held records are then released in sequence order. When
+// both lines have read past the missing sequence (or are exhausted), or a
+// channel holds more than `window` records, the gap is given up and the
+// held records are released without it. An unsequenced record held behind
+// a gap keeps its place after the newest sequence read before it.
+//
+// Delivered sequences are kept per channel in a sliding bitmap. A sequence
+// that has slid out of the window is treated as already delivered. The
+// newest `window` unsequenced records per channel are remembered; a copy of
+// an older one is delivered again.
+
+// Delivered sequences of one channel: a bit per sequence in
+// [base, base + capacity), slid forward as newer sequences arrive
+class SequenceWindow {
+public:
+    // Capacity is rounded up to a power of two, at least 64
+    explicit SequenceWindow(std::size_t capacity = 4096);
+
+    // True if the sequence was new and is now marked; false if already
+    // marked or older than the window
+    bool mark(sequence_t sequence);
+    bool contains(sequence_t sequence) const noexcept;
+
+    std::size_t capacity() const noexcept { return bits_.size() * 64; }
+
+private:
+    std::vector<std::uint64_t> bits_;  // Ring: bit (sequence % capacity)
+    sequence_t base_ = 0;              // Oldest sequence the window covers
+    bool started_ = false;
+
+    void slide_to(sequence_t base);
+};
+
+struct ArbiterStats {
+    std::array<std::uint64_t, 2> read{};       // Valid records read per line
+    std::array<std::uint64_t, 2> delivered{};  // Delivered per line (wins)
+    std::uint64_t duplicates = 0;              // Dropped copies
+    std::uint64_t held = 0;                    // Waited behind a gap
+    std::uint64_t gaps = 0;                    // Sequences neither line delivered
+};
+
+class FeedArbiter {
+public:
+    explicit FeedArbiter(std::size_t window = 4096) : window_(window) {}
+
+    // Opens two files; throws std::runtime_error if either cannot be opened
+    FeedArbiter(const std::string& line_a, const std::string& line_b, std::size_t window = 4096);
+
+    // Streams stay owned by the caller and must outlive the arbiter
+    FeedArbiter(std::istream& line_a, std::istream& line_b, std::size_t window = 4096);
+
+    // Next record to apply, nullopt once both lines are exhausted
+    std::optional<MBORecord> next();
+
+    // Duplicate decision for one record of line 0 (A) or 1 (B); true = not
+    // seen yet. next() applies it before holding records behind gaps.
+    bool accept(std::size_t line, const MBORecord& record);
+
+    const ArbiterStats& stats() const noexcept { return stats_; }
+
+private:
+    // Copies of one unsequenced record
+    struct UnsequencedCopies {
+        std::array<std::uint32_t, 2> read{};   // Per line
+        std::uint32_t delivered = 0;
+    };
+
+    // Record waiting behind a gap; unsequenced ones are keyed by the newest
+    // sequence read before them
+    struct Held {
+        sequence_t key;
+        MBORecord record;
+    };
+
+    struct ChannelState {
+        SequenceWindow delivered;
+        std::array<sequence_t, 2> last_won{};   // Last sequence each line delivered
+        std::array<sequence_t, 2> last_read{};  // Newest sequence each line read
+        sequence_t released = 0;                // Newest sequence released
+        bool started = false;                   // A sequence has been released
+        std::deque<Held> held;                  // By (key, arrival)
+        std::unordered_map<std::uint64_t, UnsequencedCopies> unsequenced;  // By content hash
+        std::deque<std::uint64_t> unsequenced_order;                        // Oldest first
+
+        explicit ChannelState(std::size_t window) : delivered(window) {}
+    };
+
+    std::size_t window_;
+    std::vector<ChannelState> channels_;        // In order of first sight
+    std::vector<std::vector<std::uint32_t>> slots_;  // [publisher][channel]: index + 1 into channels_, 0 = not seen
+    std::array<std::istream*, 2> inputs_{};
+    std::array<std::optional<MBORecord>, 2> heads_;
+    std::deque<MBORecord> ready_;               // Released, not yet returned
+    std::vector<std::unique_ptr<std::istream>> owned_;
+    std::string line_;
+    ArbiterStats stats_;
+
+    void refill(std::size_t line);
+    ChannelState& channel_of(const MBORecord& record);
+    bool accept_unsequenced(std::size_t line, ChannelState& channel, const MBORecord& record);
+    void hold(ChannelState& channel, MBORecord record);
+    void release(ChannelState& channel, bool flush);
+    bool gap_dead(const ChannelState& channel) const noexcept;
+    static bool arrives_first(const MBORecord& b, const MBORecord& a) noexcept;
+};
+
+} // namespace orderbook
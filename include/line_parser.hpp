@@ -0,0 +1,27 @@
+#pragma once
+
+#include "types.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+// Parses one MBO CSV line; std::nullopt for lines the parser rejects
+using LineParser = std::function<std::optional<MBORecord>(const std::string& line)>;
+
+struct LineParserInfo {
+    std::string name;
+    std::string description;
+    LineParser parse;
+};
+
+// Parser registry. The first entry is the reference parser
+// (CSVParser::parse_mbo_line); every other parser must produce identical
+// records and reject the same lines, which the differential harness checks.
+void register_line_parser(std::string name, std::string description, LineParser parser);
+const std::vector<LineParserInfo>& registered_line_parsers();
+const LineParserInfo& find_line_parser(const std::string& name);
+
+} // namespace orderbook
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "types.hpp"
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <random>
+
+namespace orderbook {
+
+// Configuration for the synthetic MBO market generator
+struct MarketGeneratorConfig {
+    std::uint64_t seed = 42;
+
+    // Instruments and channels
+    std::size_t instrument_count = 1;
+    instrument_id_t first_instrument_id = 1108;
+    publisher_id_t publisher_id = 2;
+    std::uint16_t channel_count = 1;       // Instruments are spread round-robin over channels
+    std::string symbol = "GEN";            // Multi-instrument symbols get an index suffix
+    double instrument_skew = 1.0;          // Zipf exponent for instrument activity (0 = uniform)
+
+    // Arrival process
+    timestamp_t start_time = 1752735909000000000;  // 2025-07-17T07:05:09Z
+    double events_per_second = 50000.0;            // Poisson rate across all instruments
+
+    // Price process
+    price_t initial_mid = 100 * static_cast<price_t>(PRICE_SCALE);
+    price_t tick_size = static_cast<price_t>(PRICE_SCALE) / 100;
+    double mid_volatility_ticks = 0.05;    // Std dev of the mid random walk per event
+    double mean_level_distance = 4.0;      // Mean distance from the touch in ticks
+
+    // Order flow
+    std::size_t target_resting_orders = 1000;  // Per instrument, mean-reverting book size
+    std::size_t initial_depth = 0;             // Per instrument adds emitted before the stream
+    double cancel_to_add_ratio = 0.95;
+    double trade_probability = 0.03;           // Probability an event is a marketable order
+    std::uint32_t max_sweep_levels = 3;
+
+    // Order sizes (lots, geometric)
+    size_t lot_size = 100;
+    double mean_lots = 3.0;
+};
+
+// Seeded, deterministic generator of realistic MBO flows.
+//
+// Events arrive as a Poisson process. Passive orders cluster around a
+// drifting mid, cancels target live resting orders, and marketable orders
+// sweep resting liquidity as T -> F -> C sequences. The same seed yields
+// the same stream on every platform (no std:: distributions are used).
+class MarketGenerator {
+public:
+    explicit MarketGenerator(MarketGeneratorConfig config = {});
+
+    // Next record in the stream
+    MBORecord next();
+
+    // Convenience helpers
+    std::vector<MBORecord> generate(std::size_t count);
+    void write_csv(std::ostream& output, std::size_t count, bool with_header = true);
+
+    // CSV in the 15-field layout parse_mbo_line expects
+    static std::string csv_header();
+    static std::string format_mbo_line(const MBORecord& record);
+
+    // Introspection
+    std::size_t resting_orders() const noexcept { return resting_orders_; }
+    const MarketGeneratorConfig& config() const noexcept { return config_; }
+
+private:
+    struct GeneratedOrder {
+        price_t price;
+        size_t size;
+        Side side;
+        std::size_t live_index;
+    };
+
+    // FIFO queue per level, cancelled ids are skipped lazily
+    struct GeneratedLevel {
+        std::deque<order_id_t> queue;
+        std::uint32_t live = 0;
+    };
+
+    struct InstrumentState {
+        instrument_id_t instrument_id = 0;
+        std::uint16_t channel_id = 0;
+        std::string symbol;
+        double mid_ticks = 0.0;
+        std::map<price_t, GeneratedLevel, std::greater<price_t>> bids;
+        std::map<price_t, GeneratedLevel> asks;
+        std::unordered_map<order_id_t, GeneratedOrder> orders;
+        std::vector<order_id_t> live;
+    };
+
+    MarketGeneratorConfig config_;
+    std::mt19937_64 rng_;
+
+    std::vector<InstrumentState> instruments_;
+    std::vector<double> instrument_cdf_;
+    std::vector<sequence_t> channel_sequences_;
+    std::deque<MBORecord> pending_;
+
+    timestamp_t ts_event_;
+    timestamp_t ts_recv_;
+    order_id_t next_order_id_ = 1;
+    std::size_t resting_orders_ = 0;
+    std::size_t initial_remaining_;
+    std::size_t initial_cursor_ = 0;
+
+    // Event generation
+    void generate_event();
+    void emit_add(InstrumentState& inst);
+    void emit_cancel(InstrumentState& inst);
+    void emit_trade(InstrumentState& inst);
+
+    template<typename Levels>
+    void sweep(InstrumentState& inst, Levels& levels, Side resting_side, size_t quantity);
+
+    // Book bookkeeping
+    void insert_order(InstrumentState& inst, order_id_t order_id, Side side, price_t price, size_t size);
+    void remove_order(InstrumentState& inst, order_id_t order_id);
+
+    // Record construction
+    MBORecord make_record(const InstrumentState& inst, Action action, Side side,
+                          price_t price, size_t size, order_id_t order_id);
+    void advance_clock();
+
+    // Portable random variates
+    double uniform();
+    double exponential(double mean);
+    double normal();
+    std::uint64_t geometric(double mean);
+    std::size_t pick_instrument();
+};
+
+} // namespace orderbook
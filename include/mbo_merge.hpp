@@ -0,0 +1,73 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace orderbook {
+
+// Streaming k-way merge of MBO files, e.g. one per channel or publisher.
+//
+// Each input is read through its own fixed-size block buffer and only its
+// current record is kept parsed, so memory is M blocks however large the
+// files are. A loser tree picks the next record in (ts_recv, sequence)
+// order, ties going to the earlier input: one root-to-leaf replay of
+// log2(M) comparisons per record. Each input must already be in that order;
+// a record that goes backwards within its input is counted and still
+// delivered in file order.
+
+// Lines of a file through a fixed-size block buffer; a line longer than the
+// buffer grows it
+class BlockLineReader {
+public:
+    // Throws std::runtime_error if the file cannot be opened
+    BlockLineReader(const std::string& path, std::size_t block_size = 1 << 20);
+
+    // Next line without its newline; the view is valid until the next call
+    bool next_line(std::string_view& line);
+
+private:
+    std::ifstream input_;
+    std::vector<char> buffer_;
+    std::size_t begin_ = 0;    // Unread bytes are [begin_, end_)
+    std::size_t end_ = 0;
+    bool eof_ = false;
+
+    void fill();
+};
+
+struct MergeStats {
+    std::vector<std::uint64_t> records;       // Delivered per input
+    std::vector<std::uint64_t> out_of_order;  // Went backwards within its input
+};
+
+class MboMerger {
+public:
+    explicit MboMerger(const std::vector<std::string>& input_files, std::size_t block_size = 1 << 20);
+
+    // Next record of the merged stream, nullopt once every input is exhausted
+    std::optional<MBORecord> next();
+
+    // Input the last delivered record came from
+    std::size_t last_input() const noexcept { return tree_[0]; }
+
+    const MergeStats& stats() const noexcept { return stats_; }
+
+private:
+    std::vector<BlockLineReader> readers_;
+    std::vector<std::optional<MBORecord>> heads_;  // Current record per input, empty once exhausted
+    std::vector<std::size_t> tree_;                // [0] winner, [1, M) loser of each match
+    std::string line_;
+    MergeStats stats_;
+    bool started_ = false;
+
+    void advance(std::size_t input);
+    bool before(std::size_t lhs, std::size_t rhs) const noexcept;
+    std::size_t play(std::size_t node);
+};
+
+} // namespace orderbook
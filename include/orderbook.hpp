@@ -1,37 +1,115 @@
 #pragma once
 
 #include "types.hpp"
+#include "book_engine.hpp"
+#include "sequence_tracker.hpp"
+#include "reorder_buffer.hpp"
+#include "feed_arbiter.hpp"
+#include "mbo_merge.hpp"
 #include <map>
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <atomic>
 #include <mutex>
 #include <shared_mutex>
 #include <algorithm>
 #include <functional>
+#include <iosfwd>
+#include <string>
 
 namespace orderbook {
 
 // Forward declarations
 class OrderbookLevel;
 class OrderbookSide;
+class ReplayIndex;
+class CheckpointChain;
 
-// Internal price level structure for orderbook operations
+// Internal price level structure for orderbook operations. Allocator-aware
+// so a level inside a side's map keeps its order table in the side's arena.
 struct OrderbookPriceLevel {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    
     price_t price;
     size_t total_size;
     std::uint32_t order_count;
-    std::unordered_map<order_id_t, size_t> orders;
+    std::pmr::unordered_map<order_id_t, size_t> orders;
     
     OrderbookPriceLevel() noexcept : price(0), total_size(0), order_count(0) {}
+    explicit OrderbookPriceLevel(const allocator_type& alloc)
+        : price(0), total_size(0), order_count(0), orders(alloc) {}
+    OrderbookPriceLevel(const OrderbookPriceLevel& other, const allocator_type& alloc)
+        : price(other.price), total_size(other.total_size), order_count(other.order_count)
+        , orders(other.orders, alloc) {}
+    OrderbookPriceLevel(OrderbookPriceLevel&& other, const allocator_type& alloc)
+        : price(other.price), total_size(other.total_size), order_count(other.order_count)
+        , orders(std::move(other.orders), alloc) {}
+    OrderbookPriceLevel(const OrderbookPriceLevel&) = default;
+    OrderbookPriceLevel(OrderbookPriceLevel&&) noexcept = default;
+    OrderbookPriceLevel& operator=(const OrderbookPriceLevel&) = default;
+    OrderbookPriceLevel& operator=(OrderbookPriceLevel&&) = default;
+};
+
+// Input position a checkpoint corresponds to: the next record starts at
+// byte_offset, sequence and ts_event are those of the last applied record
+struct CheckpointPosition {
+    std::uint64_t byte_offset = 0;
+    std::uint64_t records = 0;
+    sequence_t sequence = 0;
+    timestamp_t ts_event = 0;
+};
+
+// One price level of a full-depth view. With orders requested it also lists
+// the level's resting orders (L3), by order id since the book keeps no queue
+// priority.
+struct BookLevel {
+    price_t price = 0;
+    size_t size = 0;
+    std::uint32_t count = 0;
+    std::vector<std::pair<order_id_t, size_t>> orders;
+};
+
+// A snapshot add staged for a bulk build
+struct SnapshotOrder {
+    order_id_t order_id;
+    price_t price;
+    size_t size;
+};
+
+// Keys a side has touched since its last checkpoint, for delta checkpoints.
+// Levels and their per-order entries are tracked apart from the order lookup
+// because the two can hold different sizes (see checkpoint.cpp).
+struct LevelOrderKey {
+    price_t price;
+    order_id_t order_id;
+    
+    bool operator==(const LevelOrderKey& other) const noexcept {
+        return price == other.price && order_id == other.order_id;
+    }
+};
+
+struct LevelOrderKeyHash {
+    std::size_t operator()(const LevelOrderKey& key) const noexcept {
+        return std::hash<order_id_t>{}(key.order_id) ^
+               (std::hash<price_t>{}(key.price) * 0x9E3779B97F4A7C15ull);
+    }
+};
+
+// Each key maps to whether it was absent when first touched, so keys that
+// came and went within one interval are left out of the delta.
+struct SideChanges {
+    std::unordered_map<price_t, bool> levels;
+    std::unordered_map<LevelOrderKey, bool, LevelOrderKeyHash> level_orders;
+    std::unordered_map<order_id_t, bool> orders;
 };
 
-// High-performance orderbook implementation
-class Orderbook {
+// High-performance orderbook implementation ("map" engine)
+class Orderbook final : public BookEngine {
 public:
     Orderbook();
-    ~Orderbook() = default;
+    ~Orderbook() override = default;
     
     // Non-copyable for performance
     Orderbook(const Orderbook&) = delete;
@@ -45,6 +123,57 @@ public:
     void process_mbo_record(const MBORecord& record);
     MBPRecord generate_mbp_record(const MBORecord& record) const;
     
+    // BookEngine interface
+    void apply(const MBORecord& record) override { process_mbo_record(record); }
+    std::array<PriceLevel, MAX_DEPTH> top_levels(Side side) const override;
+    std::optional<OrderView> find_order(order_id_t order_id) const override;
+    std::size_t order_count() const noexcept override;
+    
+    // Non-empty price levels on both sides
+    std::size_t level_count() const noexcept;
+    
+    // Levels best-first beyond MAX_DEPTH (depth 0 = every level)
+    std::vector<BookLevel> book_levels(Side side, std::size_t depth = 0, bool with_orders = false) const;
+    
+    // Drop every resting order and pending trade
+    void clear() noexcept;
+    
+    // Snapshot recovery: with bulk snapshots on, adds flagged FLAG_SNAPSHOT
+    // are staged and the book is built from them in one pass per side when
+    // the snapshot ends: at its FLAG_LAST record, the first record that is
+    // not a snapshot add, or finish_snapshot(). Until then queries and
+    // checkpoints see the book without the staged adds, so finish the
+    // snapshot before saving one.
+    void set_bulk_snapshots(bool enabled);
+    bool bulk_snapshots() const noexcept { return bulk_snapshots_; }
+    void finish_snapshot();
+    bool snapshot_pending() const noexcept { return !snapshot_bids_.empty() || !snapshot_asks_.empty(); }
+    
+    // Pre-size order lookup tables for the expected resting orders (both
+    // sides), so the opening book build does not rehash
+    void reserve(std::size_t expected_orders);
+    
+    // Checkpoints: binary image of every resting order, level and pending
+    // trade, tagged with the input position. Loading replaces the current
+    // state and throws std::runtime_error on a corrupt or truncated image.
+    void save_checkpoint(std::ostream& output, const CheckpointPosition& position) const;
+    void save_checkpoint(const std::string& path, const CheckpointPosition& position) const;
+    CheckpointPosition load_checkpoint(std::istream& input);
+    CheckpointPosition load_checkpoint(const std::string& path);
+    
+    // Position of a full or delta checkpoint file, read from its header only
+    static CheckpointPosition peek_checkpoint(const std::string& path);
+    
+    // Delta checkpoints: with change tracking on, save_delta writes only the
+    // levels, orders and pending trades touched since tracking started (or
+    // the last load or delta) and starts a new interval. apply_delta replays
+    // a delta on top of the state it was taken from; parent is that state's
+    // position and must match the one recorded in the delta.
+    void set_change_tracking(bool enabled);
+    bool tracks_changes() const noexcept { return track_changes_; }
+    void save_delta(std::ostream& output, const CheckpointPosition& parent, const CheckpointPosition& position);
+    CheckpointPosition apply_delta(std::istream& input, const CheckpointPosition& parent);
+    
     // Performance monitoring
     PerformanceStats get_stats() const noexcept { return stats_.load(); }
     void reset_stats() noexcept { stats_ = PerformanceStats{}; }
@@ -68,6 +197,7 @@ private:
     // Internal helper methods
     void handle_add_order(const MBORecord& record);
     void handle_cancel_order(const MBORecord& record);
+    void handle_modify_order(const MBORecord& record);
     void handle_trade_sequence(const MBORecord& record);
     void update_stats(const MBORecord& record, duration_t processing_time);
     
@@ -81,46 +211,138 @@ private:
     };
     
     std::unordered_map<order_id_t, TradeSequence> pending_trades_;
+    
+    // Staged snapshot adds (bulk snapshot mode)
+    bool bulk_snapshots_ = false;
+    std::vector<SnapshotOrder> snapshot_bids_;
+    std::vector<SnapshotOrder> snapshot_asks_;
+    
+    // Change tracking for delta checkpoints
+    bool track_changes_ = false;
+    bool cleared_since_delta_ = false;
+    std::unordered_map<order_id_t, bool> changed_trades_;
+};
+
+// Checkpoints written from a forked child. The fork shares the parent's
+// pages copy-on-write, so the parent pauses only for the fork itself (page
+// table copy) and keeps processing while the child serializes the book.
+// One child at a time: a checkpoint requested while one is still being
+// written is skipped. Fork only from a single-threaded process.
+struct BackgroundCheckpointStats {
+    std::size_t started = 0;
+    std::size_t completed = 0;
+    std::size_t failed = 0;
+    std::size_t skipped = 0;            // Previous child still writing
+    duration_t last_pause{0};           // Parent stall for the last fork
+    duration_t max_pause{0};
+    duration_t total_pause{0};
+    duration_t max_write{0};            // Fork to reap, an upper bound on the child's write
+};
+
+class BackgroundCheckpointer {
+public:
+    BackgroundCheckpointer() = default;
+    ~BackgroundCheckpointer();
+    
+    BackgroundCheckpointer(const BackgroundCheckpointer&) = delete;
+    BackgroundCheckpointer& operator=(const BackgroundCheckpointer&) = delete;
+    
+    // Returns false if skipped because the previous checkpoint is in flight.
+    // Without fork() support the image is written synchronously.
+    bool start(const Orderbook& book, const std::string& path, const CheckpointPosition& position);
+    
+    // Reaps a finished child without blocking; true when none is in flight
+    bool poll();
+    void wait();
+    
+    const BackgroundCheckpointStats& stats() const noexcept { return stats_; }
+
+private:
+    int child_ = -1;
+    std::chrono::steady_clock::time_point started_at_;
+    BackgroundCheckpointStats stats_;
+    
+    void reaped(int status);
+};
+
+// Level ordering: bids best-first descending, asks best-first ascending
+struct LevelOrder {
+    bool ascending = false;
+    
+    bool operator()(price_t lhs, price_t rhs) const noexcept {
+        return ascending ? lhs < rhs : lhs > rhs;
+    }
 };
 
 // High-performance orderbook side implementation
 class OrderbookSide {
 public:
-    OrderbookSide() noexcept = default;
+    explicit OrderbookSide(Side side = Side::BID)
+        : arena_(std::make_unique<std::pmr::unsynchronized_pool_resource>())
+        , levels_(LevelOrder{side == Side::ASK}, arena_.get())
+        , order_lookup_(arena_.get()) {}
     ~OrderbookSide() = default;
     
     // Non-copyable
     OrderbookSide(const OrderbookSide&) = delete;
     OrderbookSide& operator=(const OrderbookSide&) = delete;
     
-    // Moveable
+    // Move-constructible only: assigning would free the target's arena
+    // under its own containers
     OrderbookSide(OrderbookSide&&) noexcept = default;
-    OrderbookSide& operator=(OrderbookSide&&) noexcept = default;
+    OrderbookSide& operator=(OrderbookSide&&) = delete;
     
     // Core operations
     void add_order(order_id_t order_id, price_t price, size_t size);
     void cancel_order(order_id_t order_id, price_t price, size_t size);
     void trade_order(order_id_t order_id, price_t price, size_t size);
     
+    // New price and size for a resting order. A size change at the same price
+    // is made in place; a price change moves the order to its new level. An
+    // unknown order is added.
+    void modify_order(order_id_t order_id, price_t price, size_t size);
+    
+    // Same result as adding the orders one by one, built level by level in
+    // price order (sorts the orders)
+    void bulk_add(std::vector<SnapshotOrder>& orders);
+    
     // Query operations
     std::array<PriceLevel, MAX_DEPTH> get_top_levels() const;
     bool has_order(order_id_t order_id) const;
     size_t get_order_size(order_id_t order_id) const;
+    std::optional<std::pair<price_t, size_t>> find_order(order_id_t order_id) const;
     
     // Performance
     void clear() noexcept;
+    void reserve(std::size_t expected_orders);
     std::size_t size() const noexcept;
+    std::size_t level_count() const noexcept { return levels_.size(); }
     bool empty() const noexcept;
 
 private:
-    // Price-ordered map for efficient level access
-    std::map<price_t, OrderbookPriceLevel, std::greater<price_t>> levels_;  // BID side (descending)
-    // std::map<price_t, OrderbookPriceLevel, std::less<price_t>> levels_;  // ASK side (ascending)
+    // Checkpoints serialize and rebuild the containers directly
+    friend class Orderbook;
+    
+    using LevelMap = std::pmr::map<price_t, OrderbookPriceLevel, LevelOrder>;
+    using OrderLookup = std::pmr::unordered_map<order_id_t, std::pair<price_t, size_t>>;
+    
+    // Backs every node, bucket array and per-level table below, so a clear
+    // releases the arena instead of freeing the book node by node. Declared
+    // first: the containers must be destroyed before it.
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> arena_;
+    
+    // Price-ordered map for efficient level access, best level first
+    LevelMap levels_;
     
     // Order lookup for fast cancellation
-    std::unordered_map<order_id_t, std::pair<price_t, size_t>> order_lookup_;
+    OrderLookup order_lookup_;
+    
+    // Touched keys while the book tracks changes, null otherwise
+    std::unique_ptr<SideChanges> changes_;
     
     // Internal helpers
+    void reset_tables() noexcept;
+    void track_level_order(price_t price, order_id_t order_id);
     void update_level(price_t price, order_id_t order_id, size_t size, bool is_add);
     void remove_level_if_empty(price_t price);
     void update_order_lookup(order_id_t order_id, price_t price, size_t size, bool is_add);
@@ -141,6 +363,18 @@ public:
     // Performance optimizations
     static void preallocate_buffers(std::size_t capacity);
     static void clear_buffers() noexcept;
+    
+    // Field formatters (ISO 8601 UTC timestamps, 6-decimal prices)
+    static std::string format_timestamp(timestamp_t ts);
+    static std::string format_price(price_t price);
+    
+    // ISO 8601 UTC timestamp to nanoseconds since epoch (0 if malformed)
+    static timestamp_t parse_timestamp(const std::string& str);
+    
+    // Strict form for command-line times: nanoseconds since epoch, or
+    // YYYY-MM-DDTHH:MM:SS with an optional 1-9 digit fraction and 'Z'.
+    // Every field is validated; nullopt if anything is malformed.
+    static std::optional<timestamp_t> parse_time_argument(const std::string& str);
 
 private:
     // Thread-local buffers for parsing
@@ -148,12 +382,9 @@ private:
     static thread_local std::string line_buffer_;
     
     // Helper methods
-    static timestamp_t parse_timestamp(const std::string& str);
     static price_t parse_price(const std::string& str);
     static Action parse_action(char action);
     static Side parse_side(char side);
-    static std::string format_timestamp(timestamp_t ts);
-    static std::string format_price(price_t price);
 };
 
 // High-performance orderbook processor
@@ -172,15 +403,156 @@ public:
     // Configuration
     void set_buffer_size(std::size_t size) noexcept { buffer_size_ = size; }
     void set_thread_count(std::size_t count) noexcept { thread_count_ = count; }
+    
+    // Checkpointing: write a checkpoint every N records (at chunk boundaries;
+    // 0 = only at end of input), and/or resume from a checkpoint, continuing
+    // at its input byte offset instead of replaying the file from the start
+    void set_checkpoint_output(const std::string& path, std::size_t every_records = 0) {
+        checkpoint_path_ = path;
+        checkpoint_every_ = every_records;
+    }
+    void set_resume_checkpoint(const std::string& path) { resume_checkpoint_ = path; }
+    
+    // Fast-forward: apply records to the book without snapshots or formatting
+    // until the first record at or past the start ts_event or sequence
+    // (whichever is set and reached first), then write rows as usual.
+    // State-only runs never write rows or open the output file; combine with
+    // a checkpoint output to build checkpoints at raw book-update speed.
+    void set_output_start(std::optional<timestamp_t> ts_event, std::optional<sequence_t> sequence = std::nullopt) {
+        start_ts_event_ = ts_event;
+        start_sequence_ = sequence;
+    }
+    void set_state_only(bool state_only) noexcept { state_only_ = state_only; }
+    
+    // Periodic checkpoints from a forked child instead of the processing
+    // thread (the end-of-input checkpoint is still written in place)
+    void set_background_checkpoints(bool enabled) noexcept { background_checkpoints_ = enabled; }
+    const BackgroundCheckpointStats& background_checkpoint_stats() const noexcept { return background_stats_; }
+    const CheckpointPosition& position() const noexcept { return position_; }
+    
+    // Restore-point chain (see checkpoint_chain.hpp): a point every N records
+    // and at end of input, a full image every full_every points and deltas
+    // in between; keep > 0 compacts the chain to that many points at the end.
+    // Resuming from a chain continues at its newest point.
+    void set_checkpoint_chain(const std::string& prefix, std::size_t every_records,
+                              std::size_t full_every = 16, std::size_t keep = 0) {
+        chain_prefix_ = prefix;
+        chain_every_ = every_records;
+        chain_full_every_ = full_every;
+        chain_keep_ = keep;
+    }
+    void set_resume_chain(const std::string& prefix) { resume_chain_ = prefix; }
+    
+    // Build snapshot recovery sequences in bulk (see Orderbook::set_bulk_snapshots).
+    // Rows for a snapshot's records before its last show the book without
+    // the staged adds; a checkpoint inside a snapshot builds what is staged.
+    // Parallel runs stage the same way, and never start a segment inside a
+    // staged snapshot.
+    void set_bulk_snapshots(bool enabled) { orderbook_.set_bulk_snapshots(enabled); }
+    
+    // Event batches: apply every record but write a row only for the last
+    // record of each matching event (FLAG_LAST), so intermediate states such
+    // as a sweep half way through are never emitted
+    void set_event_batches(bool enabled) noexcept { event_batches_ = enabled; }
+    std::uint64_t suppressed_rows() const noexcept { return suppressed_rows_; }
+    
+    // Sequence checks per (publisher, channel) on every record of a
+    // sequential run, the state pass of a parallel run and a window replay.
+    // A gap or duplicate marks the book invalid until the next clear.
+    void set_gap_handler(SequenceTracker::GapHandler handler) { sequence_tracker_.set_gap_handler(std::move(handler)); }
+    const SequenceTracker& sequence_tracker() const noexcept { return sequence_tracker_; }
+    
+    // Reorder stage (see reorder_buffer.hpp) between parsing and the book,
+    // for sequential runs without periodic checkpoints
+    void set_reorder(const ReorderConfig& config) { reorder_config_ = config; }
+    const ReorderStats& reorder_stats() const noexcept { return reorder_stats_; }
+    
+    // Two-phase parallel replay: a state-only pass checkpoints the book at
+    // `segments` boundaries (equal byte ranges, snapped to line starts), then
+    // up to thread_count workers write each segment's rows from its
+    // checkpoint. The parts are concatenated, so the output is identical to
+    // process_file. An output start cuts rows where the sequential
+    // fast-forward would end; a state-only run is just the state pass.
+    // Checkpoints and chain points are written by the state pass exactly as
+    // process_file writes them.
+    void process_file_parallel(const std::string& input_file, const std::string& output_file,
+                               std::size_t segments);
+    
+    // Rebuild the window [t0, t1] of ts_event from the nearest checkpoint in
+    // the index (or the start of the file): records before t0 are applied
+    // without output, rows are written from the first record at or after t0
+    // up to the first later record past t1
+    void process_window(const std::string& input_file, const std::string& output_file,
+                        const ReplayIndex& index, timestamp_t t0, timestamp_t t1);
+    
+    // A/B arbitration (see feed_arbiter.hpp): apply two redundant lines as
+    // one, each sequence once from whichever line delivered it first. No
+    // checkpoints or reordering, since there is no single input position.
+    void process_feeds(const std::string& line_a, const std::string& line_b,
+                       const std::string& output_file, std::size_t window = 4096);
+    const ArbiterStats& arbiter_stats() const noexcept { return arbiter_stats_; }
+    
+    // K-way merge (see mbo_merge.hpp): apply several time-ordered files, e.g.
+    // one per channel, as one stream in (ts_recv, sequence) order without
+    // sorting them first. Same restrictions as process_feeds.
+    void process_merged(const std::vector<std::string>& input_files, const std::string& output_file);
+    const MergeStats& merge_stats() const noexcept { return merge_stats_; }
 
 private:
     Orderbook orderbook_;
     std::size_t buffer_size_ = BUFFER_SIZE;
     std::size_t thread_count_ = 4;  // Default thread count
     
+    // Checkpoint state
+    std::string checkpoint_path_;
+    std::size_t checkpoint_every_ = 0;
+    std::string resume_checkpoint_;
+    CheckpointPosition position_;
+    bool background_checkpoints_ = false;
+    BackgroundCheckpointStats background_stats_;
+    std::string chain_prefix_;
+    std::size_t chain_every_ = 0;
+    std::size_t chain_full_every_ = 16;
+    std::size_t chain_keep_ = 0;
+    std::string resume_chain_;
+    std::uint64_t last_checkpoint_ = 0;   // Records at the last periodic checkpoint
+    std::uint64_t last_chain_point_ = 0;  // ... and chain point
+    
+    // Fast-forward state
+    std::optional<timestamp_t> start_ts_event_;
+    std::optional<sequence_t> start_sequence_;
+    bool state_only_ = false;
+    bool emitting_ = true;
+    
+    // Event batching
+    bool event_batches_ = false;
+    std::uint64_t suppressed_rows_ = 0;
+    
+    SequenceTracker sequence_tracker_;
+    
+    // Reordering
+    std::optional<ReorderConfig> reorder_config_;
+    std::unique_ptr<ReorderBuffer> reorder_;
+    ReorderStats reorder_stats_;
+    
+    ArbiterStats arbiter_stats_;
+    MergeStats merge_stats_;
+    
     // Processing methods
+    void apply_record(const MBORecord& record);
     void process_chunk(const std::vector<std::string>& lines);
+    void handle_record(const MBORecord& record);
+    void process_records(const std::function<std::optional<MBORecord>()>& next, const std::string& output_file);
     void write_mbp_record(const MBPRecord& record, std::ofstream& output);
+    void resume_from_checkpoint(std::ifstream& input, const std::string& input_file,
+                                CheckpointChain* chain = nullptr);
+    
+    // Shared by sequential and parallel runs: periodic checkpoints and chain
+    // points once enough records have passed since the last ones, and the
+    // end-of-input checkpoint, final chain point and compaction
+    void save_periodic_checkpoints(CheckpointChain* chain, BackgroundCheckpointer& checkpointer);
+    void save_final_checkpoints(CheckpointChain* chain, BackgroundCheckpointer& checkpointer);
+    void write_header(std::ofstream& output) const;
     
     // Output buffer for processed records
     std::vector<std::string> processed_records_;
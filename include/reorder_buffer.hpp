@@ -0,0 +1,99 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace orderbook {
+
+// Bounded reorder stage for captures that interleave records slightly out of
+// order. Records are held in a min-heap on their key and released in key
+// order once the window no longer needs them:
+//
+//  - by count: more than max_records are held, or
+//  - by distance: the newest key seen is more than max_distance ahead of
+//    the smallest held key (nanoseconds for TS_RECV, sequence numbers for
+//    SEQUENCE)
+//
+// Equal keys leave in arrival order. A record that arrives after a larger key
+// counts as late; if a larger key has already been released, it can no longer
+// be put in order and is dropped. SEQUENCE ordering is only meaningful for a
+// stream of one channel, because sequences of different channels do not
+// compare. Under SEQUENCE, unsequenced records (sequence 0, e.g. a clear)
+// stay where they arrived relative to the records before them.
+
+enum class ReorderKey : std::uint8_t {
+    TS_RECV,
+    SEQUENCE
+};
+
+struct ReorderConfig {
+    ReorderKey key = ReorderKey::TS_RECV;
+    std::size_t max_records = 1024;    // 0 = no count bound
+    std::uint64_t max_distance = 0;    // 0 = no distance bound
+};
+
+struct ReorderStats {
+    std::uint64_t records = 0;
+    std::uint64_t late = 0;            // Arrived after a larger key
+    std::uint64_t dropped = 0;         // Late beyond the window
+    std::size_t max_held = 0;
+};
+
+class ReorderBuffer {
+public:
+    // Throws std::runtime_error if neither bound is set
+    explicit ReorderBuffer(const ReorderConfig& config);
+
+    // Buffers a record, then passes every record the window releases to
+    // release(MBORecord&), smallest key first
+    template<typename Release>
+    void push(MBORecord record, Release&& release) {
+        if (!admit(std::move(record))) {
+            return;
+        }
+        while (!heap_.empty() && must_release()) {
+            release(pop());
+        }
+    }
+
+    // End of input: release everything still held
+    template<typename Release>
+    void flush(Release&& release) {
+        while (!heap_.empty()) {
+            release(pop());
+        }
+    }
+
+    std::size_t held() const noexcept { return heap_.size(); }
+    const ReorderStats& stats() const noexcept { return stats_; }
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::uint64_t arrival;
+        MBORecord record;
+    };
+
+    // Heap order: the smallest (key, arrival) on top
+    struct Later {
+        bool operator()(const Entry& lhs, const Entry& rhs) const noexcept {
+            return lhs.key != rhs.key ? lhs.key > rhs.key : lhs.arrival > rhs.arrival;
+        }
+    };
+
+    ReorderConfig config_;
+    std::vector<Entry> heap_;
+    ReorderStats stats_;
+    std::uint64_t newest_key_ = 0;
+    std::uint64_t released_key_ = 0;
+    bool released_any_ = false;
+
+    std::uint64_t key_of(const MBORecord& record) const noexcept;
+    bool admit(MBORecord record);
+    bool must_release() const noexcept;
+    MBORecord pop();
+};
+
+} // namespace orderbook
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+// Sparse (ts_event, sequence, byte offset) index over an MBO CSV file.
+//
+// An entry is taken every N records or every T milliseconds of event time,
+// whichever comes first, and points at the start of a record line. Entries
+// can carry a book checkpoint of the state just before that record, so a
+// window [t0, t1] is rebuilt by loading the nearest checkpoint and replaying
+// only the tail instead of the whole file.
+//
+// ts_event and sequence are running maxima, so they stay monotonic (and
+// binary-searchable) even where the feed itself is slightly out of order.
+
+struct IndexEntry {
+    timestamp_t ts_event = 0;      // Highest ts_event up to and including this record
+    sequence_t sequence = 0;       // Highest sequence up to and including this record
+    std::uint64_t byte_offset = 0; // Start of the record line
+    std::uint64_t records = 0;     // Records before this one
+    bool has_checkpoint = false;
+};
+
+struct IndexConfig {
+    std::size_t every_records = 100000;
+    std::int64_t every_ms = 1000;        // Event time between entries (0 = records only)
+    std::size_t checkpoint_every = 0;    // Checkpoint every K-th entry (0 = none)
+    std::string checkpoint_dir;          // Default: <index file>.ckpt
+};
+
+class ReplayIndex {
+public:
+    // Scans the input once; with checkpoints enabled the book is replayed
+    // (without MBP output) and saved at every checkpoint entry
+    static ReplayIndex build(const std::string& input_file, const std::string& index_file,
+                             const IndexConfig& config);
+
+    // Throws std::runtime_error on a missing, corrupt or truncated index
+    static ReplayIndex load(const std::string& index_file);
+    void save(const std::string& index_file) const;
+
+    // Last entry before the first record with ts_event >= ts (or sequence
+    // >= sequence); nullopt means start from the first record of the file
+    std::optional<IndexEntry> seek_time(timestamp_t ts) const;
+    std::optional<IndexEntry> seek_sequence(sequence_t sequence) const;
+
+    // Same as seek_time, restricted to entries with a checkpoint
+    std::optional<IndexEntry> seek_checkpoint(timestamp_t ts) const;
+
+    std::string checkpoint_path(const IndexEntry& entry) const;
+
+    const std::vector<IndexEntry>& entries() const noexcept { return entries_; }
+    const IndexConfig& config() const noexcept { return config_; }
+    std::uint64_t input_size() const noexcept { return input_size_; }
+    std::uint64_t data_offset() const noexcept { return data_offset_; }  // First record line
+
+    // Default sidecar path for an input file
+    static std::string default_path(const std::string& input_file) { return input_file + ".idx"; }
+
+private:
+    IndexConfig config_;
+    std::uint64_t input_size_ = 0;
+    std::uint64_t data_offset_ = 0;
+    std::vector<IndexEntry> entries_;
+};
+
+} // namespace orderbook
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace orderbook {
+
+// Per-channel sequence checking, keyed by (publisher_id, channel_id).
+//
+// The last sequence of each channel lives in a dense two-level array
+// (publisher, then channel) that grows the first time a key is seen, so the
+// per-record check is two indexed loads and one compare. A record may repeat
+// the previous sequence: one venue message can produce several MBO records.
+// Anything else but the next sequence takes the out-of-line path:
+//
+//  - above the next one: a gap, the skipped sequences are missing
+//  - below the previous one: a duplicate or stale record
+//
+// Either marks the book invalid and calls the gap handler, which is where a
+// recovery (snapshot request, replay from another source) would be started.
+// The book stays invalid until revalidate(), typically at the next clear.
+// Sequence 0 means unsequenced (e.g. the initial clear) and is not checked.
+
+enum class SequenceStatus : std::uint8_t {
+    IN_SEQUENCE,
+    GAP,
+    DUPLICATE,
+    UNSEQUENCED
+};
+
+struct SequenceGap {
+    publisher_id_t publisher_id;
+    std::uint16_t channel_id;
+    sequence_t expected;    // Next sequence the channel was waiting for
+    sequence_t received;    // Above expected for a gap, below for a duplicate
+};
+
+struct SequenceStats {
+    std::uint64_t gaps = 0;
+    std::uint64_t missing = 0;      // Sequences skipped over by gaps
+    std::uint64_t duplicates = 0;
+    std::size_t channels = 0;       // Distinct (publisher, channel) keys seen
+};
+
+class SequenceTracker {
+public:
+    using GapHandler = std::function<void(const SequenceGap&)>;
+
+    SequenceStatus check(const MBORecord& record) {
+        return check(record.publisher_id, record.channel_id, record.sequence);
+    }
+
+    SequenceStatus check(publisher_id_t publisher_id, std::uint16_t channel_id, sequence_t sequence) {
+        if (publisher_id < last_.size()) {
+            auto& channels = last_[publisher_id];
+            // Unsigned: true only for the previous sequence and the next one
+            if (channel_id < channels.size() && sequence - channels[channel_id] <= 1) {
+                channels[channel_id] = sequence;
+                return SequenceStatus::IN_SEQUENCE;
+            }
+        }
+        return check_slow(publisher_id, channel_id, sequence);
+    }
+
+    void set_gap_handler(GapHandler handler) { handler_ = std::move(handler); }
+
+    // False from the first gap or duplicate until revalidate()
+    bool book_valid() const noexcept { return valid_; }
+    void revalidate() noexcept { valid_ = true; }
+
+    // Forget every channel and counter
+    void reset();
+
+    SequenceStats stats() const;
+
+private:
+    std::vector<std::vector<sequence_t>> last_;  // [publisher][channel], 0 = not seen yet
+    SequenceStats stats_;
+    GapHandler handler_;
+    bool valid_ = true;
+
+    SequenceStatus check_slow(publisher_id_t publisher_id, std::uint16_t channel_id, sequence_t sequence);
+};
+
+} // namespace orderbook
@@ -22,14 +22,18 @@ constexpr std::size_t MAX_DEPTH = 10;
 constexpr std::size_t PRICE_SCALE = 1000000;  // 6 decimal places for price precision
 constexpr std::size_t BUFFER_SIZE = 8192;      // Optimized for L1 cache
 
+// MBO flag bits (Databento conventions)
+constexpr std::uint32_t FLAG_LAST = 1u << 7;   // Last record of a matching event
+constexpr std::uint32_t FLAG_SNAPSHOT = 1u << 5;  // Part of a book snapshot (recovery)
+
 // Action types (using char for memory efficiency)
 enum class Action : char {
     ADD = 'A',
     CANCEL = 'C',
     TRADE = 'T',
     FILL = 'F',
-    REPLACE = 'R',
-    CLEAR = 'R'  // Same as REPLACE but different context
+    MODIFY = 'M',   // New price and/or size for a resting order
+    CLEAR = 'R'     // Book reset
 };
 
 // Side types
@@ -0,0 +1,338 @@
+#!/usr/bin/env python3
+"""Benchmark baseline store and regression report.
+
+Runs the benchmark executables several times, keeps the per-metric samples
+together with a machine fingerprint and the git revision, and compares
+later runs against the stored baseline.
+
+    scripts/bench_baseline.py record  [--repetitions 5] [--build-dir build]
+    scripts/bench_baseline.py compare [--repetitions 5] [--build-dir build]
+    scripts/bench_baseline.py show
+
+A metric is flagged when its mean moved in the worse direction by more than
+the larger of --min-change and the combined 95% confidence intervals of the
+two runs, so noisy metrics need a bigger move before they are reported.
+compare exits with status 1 when any metric regressed.
+
+Baselines live in .bench-baselines/<fingerprint>.json, one file per
+machine/compiler combination, so results from different hosts are never
+compared with each other. Only the Python standard library is used.
+"""
+
+import argparse
+import hashlib
+import json
+import math
+import os
+import platform
+import re
+import statistics
+import subprocess
+import sys
+from datetime import datetime, timezone
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_BASELINE_DIR = os.path.join(REPO_ROOT, ".bench-baselines")
+
+GOOGLE_BENCHMARKS = ["benchmark_orderbook", "benchmark_csv_parser"]
+SIMPLE_BENCHMARK = "simple_performance_test"
+
+# Two-sided 95% Student t critical values by degrees of freedom
+T_CRITICAL_95 = [
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+]
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+# ---------------------------------------------------------------------------
+# Environment
+
+def run_text(command, cwd=REPO_ROOT):
+    try:
+        return subprocess.run(command, cwd=cwd, capture_output=True, text=True,
+                              check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ""
+
+
+def cpu_model():
+    try:
+        with open("/proc/cpuinfo") as cpuinfo:
+            for line in cpuinfo:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return run_text(["sysctl", "-n", "machdep.cpu.brand_string"]) or platform.processor()
+
+
+def machine_fingerprint():
+    compiler = os.environ.get("CXX", "g++")
+    info = {
+        "cpu": cpu_model(),
+        "cores": os.cpu_count(),
+        "machine": platform.machine(),
+        "system": platform.system(),
+        "kernel": platform.release(),
+        "compiler": run_text([compiler, "--version"]).splitlines()[0:1],
+        "hostname": platform.node(),
+    }
+    info["compiler"] = info["compiler"][0] if info["compiler"] else compiler
+    # Hostname and kernel are informational; the id covers what changes results
+    key = "|".join(str(info[k]) for k in ("cpu", "cores", "machine", "system", "compiler"))
+    info["id"] = hashlib.sha1(key.encode()).hexdigest()[:12]
+    return info
+
+
+def git_revision():
+    revision = run_text(["git", "rev-parse", "HEAD"]) or "unknown"
+    dirty = bool(run_text(["git", "status", "--porcelain", "--untracked-files=no"]))
+    return {"revision": revision, "dirty": dirty,
+            "subject": run_text(["git", "log", "-1", "--format=%s"])}
+
+
+# ---------------------------------------------------------------------------
+# Collection
+
+def run_google_benchmark(executable, benchmark_filter):
+    """Metrics of one executable, or None if it produced no JSON (e.g. the
+    filter matched none of its benchmarks: it says so and exits 0)."""
+    command = [executable, "--benchmark_format=json"]
+    if benchmark_filter:
+        command.append("--benchmark_filter=" + benchmark_filter)
+    output = subprocess.run(command, capture_output=True, text=True, check=True).stdout
+    try:
+        report = json.loads(output)
+    except ValueError:
+        return None
+    metrics = {}
+    for entry in report.get("benchmarks", []):
+        if entry.get("run_type", "iteration") != "iteration" or "real_time" not in entry:
+            continue
+        name = os.path.basename(executable) + "/" + entry["name"]
+        scale = TIME_UNIT_NS.get(entry.get("time_unit", "ns"), 1.0)
+        metrics[name + ":real_time"] = ("ns", "lower", entry["real_time"] * scale)
+        if "items_per_second" in entry:
+            metrics[name + ":items_per_second"] = ("items/s", "higher", entry["items_per_second"])
+    return metrics
+
+
+SECTION = re.compile(r"^\d+\.\s+(.+?)\s+Test\s*$")
+THROUGHPUT = re.compile(r"^\s*Throughput:\s*([0-9.]+)\s+(.+?)/second")
+
+
+def run_simple_benchmark(executable):
+    output = subprocess.run([executable], capture_output=True, text=True, check=True).stdout
+    metrics = {}
+    section = None
+    for line in output.splitlines():
+        match = SECTION.match(line)
+        if match:
+            section = match.group(1).lower().replace(" ", "_")
+            continue
+        match = THROUGHPUT.match(line)
+        if match and section:
+            name = "{}/{}:{}_per_second".format(
+                SIMPLE_BENCHMARK, section, match.group(2).replace(" ", "_"))
+            metrics[name] = (match.group(2) + "/s", "higher", float(match.group(1)))
+    return metrics
+
+
+def collect(build_dir, repetitions, benchmark_filter):
+    targets = [(name, "google") for name in GOOGLE_BENCHMARKS] + [(SIMPLE_BENCHMARK, "simple")]
+    samples = {}
+    for repetition in range(repetitions):
+        for name, kind in targets:
+            executable = os.path.join(build_dir, name)
+            if not os.access(executable, os.X_OK):
+                if repetition == 0:
+                    print("  skipping {} (not built)".format(name), file=sys.stderr)
+                continue
+            print("  [{}/{}] {}".format(repetition + 1, repetitions, name), file=sys.stderr)
+            if kind == "google":
+                metrics = run_google_benchmark(executable, benchmark_filter)
+                if metrics is None:
+                    if repetition == 0:
+                        print("  skipping {} (no benchmarks matched the filter)".format(name),
+                              file=sys.stderr)
+                    continue
+            else:
+                metrics = run_simple_benchmark(executable)
+            for metric, (unit, better, value) in metrics.items():
+                entry = samples.setdefault(metric, {"unit": unit, "better": better, "samples": []})
+                entry["samples"].append(value)
+
+    for entry in samples.values():
+        entry.update(summarize(entry["samples"]))
+    return samples
+
+
+# ---------------------------------------------------------------------------
+# Statistics
+
+def summarize(values):
+    mean = statistics.fmean(values)
+    stdev = statistics.stdev(values) if len(values) > 1 else 0.0
+    if len(values) > 1:
+        t = T_CRITICAL_95[min(len(values) - 1, len(T_CRITICAL_95)) - 1]
+        half_width = t * stdev / math.sqrt(len(values))
+    else:
+        half_width = float("inf")  # A single run says nothing about noise
+    return {"mean": mean, "stdev": stdev, "ci95": half_width}
+
+
+def compare_metric(base, current, min_change):
+    """Returns (relative change in the worse direction, noise threshold, verdict)."""
+    if base["mean"] == 0:
+        return 0.0, 0.0, "n/a"
+    change = (current["mean"] - base["mean"]) / base["mean"]
+    worse = change if base["better"] == "lower" else -change
+    noise = (base["ci95"] + current["ci95"]) / abs(base["mean"])
+    threshold = max(min_change, noise)
+    if math.isinf(threshold):
+        return worse, threshold, "noisy"
+    if worse > threshold:
+        return worse, threshold, "REGRESSION"
+    if worse < -threshold:
+        return worse, threshold, "improved"
+    return worse, threshold, "ok"
+
+
+# ---------------------------------------------------------------------------
+# Baseline files
+
+def baseline_path(args, fingerprint):
+    if args.baseline:
+        return args.baseline
+    return os.path.join(DEFAULT_BASELINE_DIR, fingerprint["id"] + ".json")
+
+
+def make_run(args):
+    fingerprint = machine_fingerprint()
+    print("Running benchmarks ({} repetitions) on {} [{}]".format(
+        args.repetitions, fingerprint["cpu"], fingerprint["id"]), file=sys.stderr)
+    return {
+        "timestamp": datetime.now(timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ"),
+        "machine": fingerprint,
+        "git": git_revision(),
+        "repetitions": args.repetitions,
+        "metrics": collect(args.build_dir, args.repetitions, args.filter),
+    }
+
+
+def load_baseline(path):
+    try:
+        with open(path) as baseline:
+            return json.load(baseline)
+    except FileNotFoundError:
+        sys.exit("No baseline at {} (run 'record' first)".format(path))
+
+
+def save_run(path, run):
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, "w") as output:
+        json.dump(run, output, indent=2, sort_keys=True)
+        output.write("\n")
+
+
+def describe(run):
+    git = run["git"]
+    return "{} {}{} ({})".format(run["timestamp"], git["revision"][:10],
+                                 "+dirty" if git["dirty"] else "", git["subject"])
+
+
+# ---------------------------------------------------------------------------
+# Commands
+
+def command_record(args):
+    run = make_run(args)
+    path = baseline_path(args, run["machine"])
+    save_run(path, run)
+    print("Recorded {} metrics to {}".format(len(run["metrics"]), path))
+    return 0
+
+
+def command_compare(args):
+    fingerprint = machine_fingerprint()
+    path = baseline_path(args, fingerprint)
+    baseline = load_baseline(path)
+    if baseline["machine"]["id"] != fingerprint["id"] and not args.force:
+        sys.exit("Baseline was recorded on a different machine ({} vs {}); use --force to compare anyway"
+                 .format(baseline["machine"]["id"], fingerprint["id"]))
+
+    run = make_run(args)
+    print("Baseline: " + describe(baseline))
+    print("Current:  " + describe(run))
+    print()
+    print("{:<72} {:>14} {:>14} {:>8} {:>8}  {}".format(
+        "Metric", "Baseline", "Current", "Worse", "Noise", "Verdict"))
+    print("-" * 130)
+
+    regressions = 0
+    for metric in sorted(set(baseline["metrics"]) | set(run["metrics"])):
+        base = baseline["metrics"].get(metric)
+        current = run["metrics"].get(metric)
+        if base is None or current is None:
+            print("{:<72} {:>14} {:>14}".format(metric, "-" if base is None else "{:.4g}".format(base["mean"]),
+                                                 "-" if current is None else "{:.4g}".format(current["mean"])))
+            continue
+        worse, threshold, verdict = compare_metric(base, current, args.min_change)
+        regressions += verdict == "REGRESSION"
+        print("{:<72} {:>14.4g} {:>14.4g} {:>+7.1f}% {:>7.1f}%  {}".format(
+            metric, base["mean"], current["mean"], worse * 100,
+            threshold * 100 if not math.isinf(threshold) else float("nan"), verdict))
+
+    print()
+    print("{} regression(s) beyond noise".format(regressions))
+    if args.update:
+        save_run(path, run)
+        print("Baseline updated: " + path)
+    if args.output:
+        save_run(args.output, run)
+    return 1 if regressions else 0
+
+
+def command_show(args):
+    path = baseline_path(args, machine_fingerprint())
+    baseline = load_baseline(path)
+    machine = baseline["machine"]
+    print("Baseline {}".format(path))
+    print("  {}".format(describe(baseline)))
+    print("  {} ({} cores), {} {}, {}".format(machine["cpu"], machine["cores"], machine["system"],
+                                             machine["kernel"], machine["compiler"]))
+    print()
+    for metric, entry in sorted(baseline["metrics"].items()):
+        relative = entry["ci95"] / entry["mean"] * 100 if entry["mean"] else 0.0
+        print("{:<72} {:>14.4g} {:<10} ±{:.1f}%".format(metric, entry["mean"], entry["unit"], relative))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("command", choices=["record", "compare", "show"])
+    parser.add_argument("--build-dir", default=os.path.join(REPO_ROOT, "build"),
+                        help="directory with the benchmark executables (default build)")
+    parser.add_argument("--repetitions", type=int, default=5,
+                        help="process-level runs per target (default 5)")
+    parser.add_argument("--baseline", help="baseline file (default .bench-baselines/<fingerprint>.json)")
+    parser.add_argument("--filter", default="",
+                        help="Google Benchmark --benchmark_filter regex")
+    parser.add_argument("--min-change", type=float, default=0.05,
+                        help="smallest relative change ever flagged (default 0.05 = 5%%)")
+    parser.add_argument("--update", action="store_true", help="compare: replace the baseline afterwards")
+    parser.add_argument("--force", action="store_true", help="compare: ignore a fingerprint mismatch")
+    parser.add_argument("--output", help="compare: also write the current run to this file")
+    args = parser.parse_args()
+
+    if args.repetitions < 1:
+        parser.error("--repetitions must be at least 1")
+
+    commands = {"record": command_record, "compare": command_compare, "show": command_show}
+    return commands[args.command](args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,45 @@
+#include "book_engine.hpp"
+#include "orderbook.hpp"
+#include <stdexcept>
+
+namespace orderbook {
+
+namespace {
+
+std::vector<BookEngineInfo>& engine_registry() {
+    // Built-in engines; add new implementations here
+    static std::vector<BookEngineInfo> registry = {
+        {"map", "std::map price levels + hash map order lookup (Orderbook)",
+         [] { return std::unique_ptr<BookEngine>(std::make_unique<Orderbook>()); }},
+    };
+    return registry;
+}
+
+} // namespace
+
+void register_book_engine(std::string name, std::string description, BookEngineFactory factory) {
+    auto& registry = engine_registry();
+    for (auto& info : registry) {
+        if (info.name == name) {
+            info.description = std::move(description);
+            info.create = std::move(factory);
+            return;
+        }
+    }
+    registry.push_back({std::move(name), std::move(description), std::move(factory)});
+}
+
+const std::vector<BookEngineInfo>& registered_book_engines() {
+    return engine_registry();
+}
+
+std::unique_ptr<BookEngine> create_book_engine(const std::string& name) {
+    for (const auto& info : engine_registry()) {
+        if (info.name == name) {
+            return info.create();
+        }
+    }
+    throw std::invalid_argument("Unknown book engine: " + name);
+}
+
+} // namespace orderbook
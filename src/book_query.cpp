@@ -0,0 +1,142 @@
+#include "book_query.hpp"
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace orderbook {
+
+BookQuery::BookQuery(std::string input_file, ReplayIndex index, std::size_t cache_states)
+    : input_file_(std::move(input_file))
+    , index_(std::move(index))
+    , cache_states_(std::max<std::size_t>(cache_states, 1))
+    , input_(input_file_, std::ios::binary) {
+    if (!input_.is_open()) {
+        throw std::runtime_error("Cannot open input file: " + input_file_);
+    }
+    input_.seekg(0, std::ios::end);
+    if (static_cast<std::uint64_t>(input_.tellg()) != index_.input_size()) {
+        throw std::runtime_error("Index was built for a different version of: " + input_file_);
+    }
+}
+
+BookQuery::BookQuery(const std::string& input_file, std::size_t cache_states)
+    : BookQuery(input_file, ReplayIndex::load(ReplayIndex::default_path(input_file)), cache_states) {}
+
+BookSnapshot BookQuery::book_at(timestamp_t ts, std::size_t depth, bool orders) {
+    stats_.queries++;
+    auto state = start_state(ts);
+    cache_.splice(cache_.begin(), cache_, state);
+    replay_to(*state, ts);
+
+    BookSnapshot snapshot;
+    snapshot.ts_event = ts;
+    snapshot.position = state->position;
+    snapshot.bids = state->book->book_levels(Side::BID, depth, orders);
+    snapshot.asks = state->book->book_levels(Side::ASK, depth, orders);
+    return snapshot;
+}
+
+std::list<BookQuery::CachedState>::iterator BookQuery::start_state(timestamp_t ts) {
+    // Furthest cached state that has not applied anything past ts
+    auto best = cache_.end();
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->max_applied <= ts && (best == cache_.end() || it->position.records > best->position.records)) {
+            best = it;
+        }
+    }
+
+    // An entry's ts_event covers its own record, so ts + 1 still only
+    // selects checkpoints whose applied records are all at or before ts
+    const auto entry = index_.seek_checkpoint(ts + 1);
+    if (best != cache_.end() && (!entry || entry->records <= best->position.records)) {
+        stats_.cache_hits++;
+        return best;
+    }
+
+    if (cache_.size() >= cache_states_) {
+        cache_.pop_back();
+    }
+    CachedState state;
+    state.book = std::make_unique<Orderbook>();
+    state.next_ts = std::numeric_limits<timestamp_t>::min();
+    if (entry) {
+        state.position = state.book->load_checkpoint(index_.checkpoint_path(*entry));
+        state.position.byte_offset = entry->byte_offset;
+        state.max_applied = entry->ts_event;
+        stats_.checkpoint_loads++;
+    } else {
+        state.position.byte_offset = index_.data_offset();
+        state.max_applied = std::numeric_limits<timestamp_t>::min();
+    }
+    cache_.push_front(std::move(state));
+    return cache_.begin();
+}
+
+void BookQuery::replay_to(CachedState& state, timestamp_t ts) {
+    if (state.next_ts > ts) {
+        return;  // Already the book at ts
+    }
+
+    input_.clear();
+    input_.seekg(static_cast<std::streamoff>(state.position.byte_offset));
+    std::uint64_t offset = state.position.byte_offset;
+    std::string line;
+    state.next_ts = std::numeric_limits<timestamp_t>::max();
+    while (std::getline(input_, line)) {
+        const std::uint64_t next_offset = offset + line.size() + (input_.eof() ? 0 : 1);
+        auto record = CSVParser::parse_mbo_line(line);
+        if (!record) {
+            offset = next_offset;
+            continue;
+        }
+        const timestamp_t ts_event = record->timestamp.ts_event;
+        if (ts_event > ts) {
+            state.next_ts = ts_event;
+            break;
+        }
+
+        state.book->process_mbo_record(*record);
+        state.position.records++;
+        state.position.sequence = record->sequence;
+        state.position.ts_event = ts_event;
+        state.max_applied = std::max(state.max_applied, ts_event);
+        stats_.records_replayed++;
+        offset = next_offset;
+    }
+    state.position.byte_offset = offset;
+}
+
+BookSnapshot book_at(const std::string& input_file, timestamp_t ts, std::size_t depth, bool orders) {
+    struct OpenQuery {
+        std::unique_ptr<BookQuery> query;
+        std::uintmax_t size = 0;
+        std::filesystem::file_time_type modified;
+    };
+    static std::mutex mutex;
+    static std::unordered_map<std::string, OpenQuery> queries;
+
+    std::error_code error;
+    const auto size = std::filesystem::file_size(input_file, error);
+    std::filesystem::file_time_type modified;
+    if (!error) {
+        modified = std::filesystem::last_write_time(input_file, error);
+    }
+    if (error) {
+        throw std::runtime_error("Cannot open input file: " + input_file);
+    }
+
+    // A rewritten or appended file needs a fresh query (and index)
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& open = queries[input_file];
+    if (!open.query || open.size != size || open.modified != modified) {
+        open.query.reset();
+        open.query = std::make_unique<BookQuery>(input_file);
+        open.size = size;
+        open.modified = modified;
+    }
+    return open.query->book_at(ts, depth, orders);
+}
+
+} // namespace orderbook
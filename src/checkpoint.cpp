@@ -0,0 +1,677 @@
+#include "orderbook.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <unordered_set>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#define ORDERBOOK_HAVE_FORK 1
+#endif
+
+namespace orderbook {
+
+// Checkpoint image layout (host byte order, version 1):
+//
+//   u32 magic "OBCK", u32 version
+//   position: u64 byte_offset, u64 records, u64 sequence, i64 ts_event
+//   bid side, ask side:
+//     u64 levels,  per level: i64 price, u32 total_size, u32 order_count,
+//                             u64 orders, per order: u64 id, u32 size
+//     u64 lookups, per order: u64 id, i64 price, u32 size
+//   u64 pending trades, per trade: u64 id, u8 side, i64 price,
+//                                  u32 remaining, i64 timestamp
+//   u64 FNV-1a checksum of everything above
+//
+// Levels and the order lookup are stored separately because the level
+// per-order sizes and the lookup sizes can legitimately differ (partial
+// cancels reduce one but remove from the other); resuming must reproduce
+// the book exactly, including that state.
+//
+// Delta image layout (host byte order, version 1):
+//
+//   u32 magic "OBDL", u32 version
+//   position: u64 byte_offset, u64 records, u64 sequence, i64 ts_event
+//   parent:   u64 byte_offset, u64 records
+//   u8 reset (the book was cleared; apply to an empty book)
+//   bid side, ask side:
+//     u64 levels,       per level: i64 price, u8 present
+//                                  [, u32 total_size, u32 order_count]
+//     u64 level orders, per entry: i64 price, u64 id, u8 present [, u32 size]
+//     u64 lookups,      per order: u64 id, u8 present [, i64 price, u32 size]
+//   u64 pending trades, per trade: u64 id, u8 present [, u8 side, i64 price,
+//                                  u32 remaining, i64 timestamp]
+//   u64 FNV-1a checksum of everything above
+//
+// Each entry is the current value of a key touched since the parent, or its
+// removal; keys added and removed again since the parent are omitted.
+// Applying the entries in order (levels before their orders) reproduces the
+// book at the delta's position.
+
+namespace {
+
+constexpr std::uint32_t CHECKPOINT_MAGIC = 0x4B43424F;  // "OBCK"
+constexpr std::uint32_t CHECKPOINT_VERSION = 1;
+constexpr std::uint32_t DELTA_MAGIC = 0x4C44424F;       // "OBDL"
+constexpr std::uint32_t DELTA_VERSION = 1;
+constexpr std::uint64_t MAX_ENTRIES = 1ull << 32;       // Sanity bound on counts
+
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t fnv1a(std::uint64_t hash, const char* data, std::size_t size) noexcept {
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Buffered writer that checksums everything it writes
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::ostream& output) : output_(output) { buffer_.reserve(BUFFER_BYTES); }
+
+    template<typename T>
+    void put(T value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+        if (buffer_.size() >= BUFFER_BYTES) {
+            flush();
+        }
+    }
+
+    void finish() {
+        flush();
+        const std::uint64_t checksum = hash_;
+        output_.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        output_.flush();
+        if (!output_) {
+            throw std::runtime_error("Cannot write checkpoint");
+        }
+    }
+
+private:
+    static constexpr std::size_t BUFFER_BYTES = 1 << 16;
+
+    std::ostream& output_;
+    std::vector<char> buffer_;
+    std::uint64_t hash_ = FNV_OFFSET;
+
+    void flush() {
+        hash_ = fnv1a(hash_, buffer_.data(), buffer_.size());
+        output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+};
+
+class CheckpointReader {
+public:
+    explicit CheckpointReader(std::istream& input) : input_(input) {
+        // Bytes left in a seekable stream bound what a count can claim
+        const auto start = input_.tellg();
+        if (start != std::istream::pos_type(-1) && input_.seekg(0, std::ios::end)) {
+            remaining_ = static_cast<std::uint64_t>(input_.tellg() - start);
+            input_.seekg(start);
+        } else {
+            input_.clear();
+        }
+    }
+
+    template<typename T>
+    T get() {
+        T value;
+        if (!input_.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            throw std::runtime_error("Invalid checkpoint: truncated image");
+        }
+        hash_ = fnv1a(hash_, reinterpret_cast<const char*>(&value), sizeof(T));
+        remaining_ -= std::min<std::uint64_t>(remaining_, sizeof(T));
+        return value;
+    }
+
+    // Entry count, rejected before anything is allocated for it if that
+    // many entries of at least entry_bytes each cannot fit in the rest of
+    // the image
+    std::uint64_t count(std::size_t entry_bytes) {
+        const auto value = get<std::uint64_t>();
+        if (value > MAX_ENTRIES) {
+            throw std::runtime_error("Invalid checkpoint: implausible entry count");
+        }
+        if (value > remaining_ / entry_bytes) {
+            throw std::runtime_error("Invalid checkpoint: truncated image");
+        }
+        return value;
+    }
+
+    void verify() {
+        const std::uint64_t expected = hash_;
+        std::uint64_t stored = 0;
+        if (!input_.read(reinterpret_cast<char*>(&stored), sizeof(stored))) {
+            throw std::runtime_error("Invalid checkpoint: missing checksum");
+        }
+        if (stored != expected) {
+            throw std::runtime_error("Invalid checkpoint: checksum mismatch");
+        }
+    }
+
+private:
+    std::istream& input_;
+    std::uint64_t remaining_ = std::numeric_limits<std::uint64_t>::max();  // Unknown if unseekable
+    std::uint64_t hash_ = FNV_OFFSET;
+};
+
+Side read_side(CheckpointReader& reader) {
+    const char side = reader.get<char>();
+    if (side != static_cast<char>(Side::BID) && side != static_cast<char>(Side::ASK) &&
+        side != static_cast<char>(Side::NEUTRAL)) {
+        throw std::runtime_error("Invalid checkpoint: bad side");
+    }
+    return static_cast<Side>(side);
+}
+
+void put_position(CheckpointWriter& writer, const CheckpointPosition& position) {
+    writer.put(position.byte_offset);
+    writer.put(position.records);
+    writer.put(position.sequence);
+    writer.put(position.ts_event);
+}
+
+CheckpointPosition get_position(CheckpointReader& reader) {
+    CheckpointPosition position;
+    position.byte_offset = reader.get<std::uint64_t>();
+    position.records = reader.get<std::uint64_t>();
+    position.sequence = reader.get<sequence_t>();
+    position.ts_event = reader.get<timestamp_t>();
+    return position;
+}
+
+// Changed keys a delta writes: those present now or at the start of the
+// interval (a key that came and went in between has nothing to restore)
+template<typename Changes, typename Present>
+std::uint64_t written_count(const Changes& changes, Present present) {
+    std::uint64_t count = 0;
+    for (const auto& [key, absent_before] : changes) {
+        count += !absent_before || present(key);
+    }
+    return count;
+}
+
+// One side of a parsed delta, held until the checksum is verified
+struct LevelChange {
+    price_t price;
+    bool present;
+    size_t total_size;
+    std::uint32_t order_count;
+};
+
+struct LevelOrderChange {
+    price_t price;
+    order_id_t order_id;
+    bool present;
+    size_t size;
+};
+
+struct LookupChange {
+    order_id_t order_id;
+    bool present;
+    price_t price;
+    size_t size;
+};
+
+struct SideDelta {
+    std::vector<LevelChange> levels;
+    std::vector<LevelOrderChange> level_orders;
+    std::vector<LookupChange> lookups;
+};
+
+} // namespace
+
+void Orderbook::save_checkpoint(std::ostream& output, const CheckpointPosition& position) const {
+    CheckpointWriter writer(output);
+    writer.put(CHECKPOINT_MAGIC);
+    writer.put(CHECKPOINT_VERSION);
+    put_position(writer, position);
+
+    for (const OrderbookSide* side : {bid_side_.get(), ask_side_.get()}) {
+        writer.put(static_cast<std::uint64_t>(side->levels_.size()));
+        for (const auto& [price, level] : side->levels_) {
+            writer.put(price);
+            writer.put(level.total_size);
+            writer.put(level.order_count);
+            writer.put(static_cast<std::uint64_t>(level.orders.size()));
+            for (const auto& [order_id, size] : level.orders) {
+                writer.put(order_id);
+                writer.put(size);
+            }
+        }
+        writer.put(static_cast<std::uint64_t>(side->order_lookup_.size()));
+        for (const auto& [order_id, order] : side->order_lookup_) {
+            writer.put(order_id);
+            writer.put(order.first);
+            writer.put(order.second);
+        }
+    }
+
+    writer.put(static_cast<std::uint64_t>(pending_trades_.size()));
+    for (const auto& [order_id, trade] : pending_trades_) {
+        writer.put(order_id);
+        writer.put(static_cast<char>(trade.side));
+        writer.put(trade.price);
+        writer.put(trade.remaining_size);
+        writer.put(trade.timestamp);
+    }
+    writer.finish();
+}
+
+void Orderbook::save_checkpoint(const std::string& path, const CheckpointPosition& position) const {
+    // Write-then-rename so a crash never leaves a half-written checkpoint
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+        if (!output.is_open()) {
+            throw std::runtime_error("Cannot open checkpoint file: " + temp_path);
+        }
+        save_checkpoint(output, position);
+    }
+    std::filesystem::rename(temp_path, path);
+}
+
+CheckpointPosition Orderbook::load_checkpoint(std::istream& input) {
+    CheckpointReader reader(input);
+    if (reader.get<std::uint32_t>() != CHECKPOINT_MAGIC) {
+        throw std::runtime_error("Invalid checkpoint: bad magic");
+    }
+    if (reader.get<std::uint32_t>() != CHECKPOINT_VERSION) {
+        throw std::runtime_error("Invalid checkpoint: unsupported version");
+    }
+
+    const CheckpointPosition position = get_position(reader);
+
+    // Rebuild into fresh sides so a failed load leaves this book untouched
+    auto bid_side = std::make_unique<OrderbookSide>(Side::BID);
+    auto ask_side = std::make_unique<OrderbookSide>(Side::ASK);
+    for (OrderbookSide* side : {bid_side.get(), ask_side.get()}) {
+        const std::uint64_t level_count =
+            reader.count(sizeof(price_t) + sizeof(size_t) + sizeof(std::uint32_t) + sizeof(std::uint64_t));
+        for (std::uint64_t i = 0; i < level_count; ++i) {
+            const auto price = reader.get<price_t>();
+            // Saved best-first, so every insert lands at the end
+            auto& level = side->levels_.emplace_hint(side->levels_.end(), price, OrderbookPriceLevel{})->second;
+            level.price = price;
+            level.total_size = reader.get<size_t>();
+            level.order_count = reader.get<std::uint32_t>();
+            const std::uint64_t order_count = reader.count(sizeof(order_id_t) + sizeof(size_t));
+            level.orders.reserve(order_count);
+            for (std::uint64_t j = 0; j < order_count; ++j) {
+                const auto order_id = reader.get<order_id_t>();
+                level.orders[order_id] = reader.get<size_t>();
+            }
+        }
+
+        const std::uint64_t lookup_count = reader.count(sizeof(order_id_t) + sizeof(price_t) + sizeof(size_t));
+        side->order_lookup_.reserve(lookup_count);
+        for (std::uint64_t i = 0; i < lookup_count; ++i) {
+            const auto order_id = reader.get<order_id_t>();
+            const auto price = reader.get<price_t>();
+            side->order_lookup_[order_id] = {price, reader.get<size_t>()};
+        }
+    }
+
+    std::unordered_map<order_id_t, TradeSequence> pending_trades;
+    const std::uint64_t pending_count = reader.count(sizeof(order_id_t) + sizeof(char) + sizeof(price_t) +
+                                                     sizeof(size_t) + sizeof(timestamp_t));
+    for (std::uint64_t i = 0; i < pending_count; ++i) {
+        TradeSequence trade;
+        trade.order_id = reader.get<order_id_t>();
+        trade.side = read_side(reader);
+        trade.price = reader.get<price_t>();
+        trade.remaining_size = reader.get<size_t>();
+        trade.timestamp = reader.get<timestamp_t>();
+        pending_trades[trade.order_id] = trade;
+    }
+    reader.verify();
+
+    bid_side_ = std::move(bid_side);
+    ask_side_ = std::move(ask_side);
+    pending_trades_ = std::move(pending_trades);
+    // Adds staged before the load belong to the replaced book
+    snapshot_bids_.clear();
+    snapshot_asks_.clear();
+    if (track_changes_) {
+        set_change_tracking(true);  // Changes are now relative to this image
+    }
+    return position;
+}
+
+CheckpointPosition Orderbook::load_checkpoint(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    return load_checkpoint(input);
+}
+
+CheckpointPosition Orderbook::peek_checkpoint(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    CheckpointReader reader(input);
+    const auto magic = reader.get<std::uint32_t>();
+    const auto version = reader.get<std::uint32_t>();
+    if ((magic != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION) &&
+        (magic != DELTA_MAGIC || version != DELTA_VERSION)) {
+        throw std::runtime_error("Invalid checkpoint: bad header in " + path);
+    }
+    return get_position(reader);
+}
+
+void Orderbook::set_change_tracking(bool enabled) {
+    for (OrderbookSide* side : {bid_side_.get(), ask_side_.get()}) {
+        side->changes_ = enabled ? std::make_unique<SideChanges>() : nullptr;
+    }
+    track_changes_ = enabled;
+    cleared_since_delta_ = false;
+    changed_trades_.clear();
+}
+
+void Orderbook::save_delta(std::ostream& output, const CheckpointPosition& parent,
+                           const CheckpointPosition& position) {
+    if (!track_changes_) {
+        throw std::logic_error("save_delta requires change tracking");
+    }
+
+    CheckpointWriter writer(output);
+    writer.put(DELTA_MAGIC);
+    writer.put(DELTA_VERSION);
+    put_position(writer, position);
+    writer.put(parent.byte_offset);
+    writer.put(parent.records);
+    writer.put(static_cast<std::uint8_t>(cleared_since_delta_));
+
+    for (const OrderbookSide* side : {bid_side_.get(), ask_side_.get()}) {
+        const SideChanges& changes = *side->changes_;
+
+        auto find_level = [&](price_t price) -> const OrderbookPriceLevel* {
+            const auto it = side->levels_.find(price);
+            return it != side->levels_.end() ? &it->second : nullptr;
+        };
+        writer.put(written_count(changes.levels, [&](price_t price) { return find_level(price) != nullptr; }));
+        for (const auto& [price, absent_before] : changes.levels) {
+            const OrderbookPriceLevel* level = find_level(price);
+            if (!level && absent_before) {
+                continue;
+            }
+            writer.put(price);
+            writer.put(static_cast<std::uint8_t>(level != nullptr));
+            if (level) {
+                writer.put(level->total_size);
+                writer.put(level->order_count);
+            }
+        }
+
+        auto find_level_order = [&](const LevelOrderKey& key) -> const size_t* {
+            const OrderbookPriceLevel* level = find_level(key.price);
+            if (!level) {
+                return nullptr;
+            }
+            const auto order = level->orders.find(key.order_id);
+            return order != level->orders.end() ? &order->second : nullptr;
+        };
+        writer.put(written_count(changes.level_orders,
+                                 [&](const LevelOrderKey& key) { return find_level_order(key) != nullptr; }));
+        for (const auto& [key, absent_before] : changes.level_orders) {
+            const size_t* size = find_level_order(key);
+            if (!size && absent_before) {
+                continue;
+            }
+            writer.put(key.price);
+            writer.put(key.order_id);
+            writer.put(static_cast<std::uint8_t>(size != nullptr));
+            if (size) {
+                writer.put(*size);
+            }
+        }
+
+        writer.put(written_count(changes.orders,
+                                 [&](order_id_t order_id) { return side->order_lookup_.count(order_id) != 0; }));
+        for (const auto& [order_id, absent_before] : changes.orders) {
+            const auto it = side->order_lookup_.find(order_id);
+            if (it == side->order_lookup_.end() && absent_before) {
+                continue;
+            }
+            writer.put(order_id);
+            writer.put(static_cast<std::uint8_t>(it != side->order_lookup_.end()));
+            if (it != side->order_lookup_.end()) {
+                writer.put(it->second.first);
+                writer.put(it->second.second);
+            }
+        }
+    }
+
+    writer.put(written_count(changed_trades_,
+                             [&](order_id_t order_id) { return pending_trades_.count(order_id) != 0; }));
+    for (const auto& [order_id, absent_before] : changed_trades_) {
+        const auto it = pending_trades_.find(order_id);
+        if (it == pending_trades_.end() && absent_before) {
+            continue;
+        }
+        writer.put(order_id);
+        writer.put(static_cast<std::uint8_t>(it != pending_trades_.end()));
+        if (it != pending_trades_.end()) {
+            writer.put(static_cast<char>(it->second.side));
+            writer.put(it->second.price);
+            writer.put(it->second.remaining_size);
+            writer.put(it->second.timestamp);
+        }
+    }
+    writer.finish();
+
+    // Next interval starts here
+    set_change_tracking(true);
+}
+
+CheckpointPosition Orderbook::apply_delta(std::istream& input, const CheckpointPosition& parent) {
+    CheckpointReader reader(input);
+    if (reader.get<std::uint32_t>() != DELTA_MAGIC) {
+        throw std::runtime_error("Invalid delta: bad magic");
+    }
+    if (reader.get<std::uint32_t>() != DELTA_VERSION) {
+        throw std::runtime_error("Invalid delta: unsupported version");
+    }
+    const CheckpointPosition position = get_position(reader);
+    const auto parent_offset = reader.get<std::uint64_t>();
+    const auto parent_records = reader.get<std::uint64_t>();
+    if (parent_offset != parent.byte_offset || parent_records != parent.records) {
+        throw std::runtime_error("Invalid delta: taken from record " + std::to_string(parent_records) +
+                                 ", book is at record " + std::to_string(parent.records));
+    }
+    const bool reset = reader.get<std::uint8_t>() != 0;
+
+    // Parse everything first so a bad delta leaves the book untouched
+    SideDelta sides[2];
+    for (SideDelta& side : sides) {
+        std::unordered_set<price_t> present_levels;
+        side.levels.resize(reader.count(sizeof(price_t) + sizeof(std::uint8_t)));
+        for (auto& level : side.levels) {
+            level.price = reader.get<price_t>();
+            level.present = reader.get<std::uint8_t>() != 0;
+            if (level.present) {
+                level.total_size = reader.get<size_t>();
+                level.order_count = reader.get<std::uint32_t>();
+                present_levels.insert(level.price);
+            }
+        }
+
+        side.level_orders.resize(reader.count(sizeof(price_t) + sizeof(order_id_t) + sizeof(std::uint8_t)));
+        for (auto& entry : side.level_orders) {
+            entry.price = reader.get<price_t>();
+            entry.order_id = reader.get<order_id_t>();
+            entry.present = reader.get<std::uint8_t>() != 0;
+            if (entry.present) {
+                entry.size = reader.get<size_t>();
+                if (!present_levels.count(entry.price)) {
+                    throw std::runtime_error("Invalid delta: order on a removed level");
+                }
+            }
+        }
+
+        side.lookups.resize(reader.count(sizeof(order_id_t) + sizeof(std::uint8_t)));
+        for (auto& lookup : side.lookups) {
+            lookup.order_id = reader.get<order_id_t>();
+            lookup.present = reader.get<std::uint8_t>() != 0;
+            if (lookup.present) {
+                lookup.price = reader.get<price_t>();
+                lookup.size = reader.get<size_t>();
+            }
+        }
+    }
+
+    std::vector<std::pair<TradeSequence, bool>> trades(reader.count(sizeof(order_id_t) + sizeof(std::uint8_t)));
+    for (auto& [trade, present] : trades) {
+        trade.order_id = reader.get<order_id_t>();
+        present = reader.get<std::uint8_t>() != 0;
+        if (present) {
+            trade.side = read_side(reader);
+            trade.price = reader.get<price_t>();
+            trade.remaining_size = reader.get<size_t>();
+            trade.timestamp = reader.get<timestamp_t>();
+        }
+    }
+    reader.verify();
+
+    if (reset) {
+        bid_side_->reset_tables();
+        ask_side_->reset_tables();
+        pending_trades_.clear();
+    }
+    snapshot_bids_.clear();
+    snapshot_asks_.clear();
+    OrderbookSide* targets[2] = {bid_side_.get(), ask_side_.get()};
+    for (int i = 0; i < 2; ++i) {
+        OrderbookSide& side = *targets[i];
+        for (const auto& change : sides[i].levels) {
+            if (!change.present) {
+                side.levels_.erase(change.price);
+                continue;
+            }
+            auto& level = side.levels_[change.price];
+            level.price = change.price;
+            level.total_size = change.total_size;
+            level.order_count = change.order_count;
+        }
+        for (const auto& change : sides[i].level_orders) {
+            auto level = side.levels_.find(change.price);
+            if (change.present) {
+                level->second.orders[change.order_id] = change.size;
+            } else if (level != side.levels_.end()) {
+                level->second.orders.erase(change.order_id);
+            }
+        }
+        for (const auto& change : sides[i].lookups) {
+            if (change.present) {
+                side.order_lookup_[change.order_id] = {change.price, change.size};
+            } else {
+                side.order_lookup_.erase(change.order_id);
+            }
+        }
+    }
+    for (const auto& [trade, present] : trades) {
+        if (present) {
+            pending_trades_[trade.order_id] = trade;
+        } else {
+            pending_trades_.erase(trade.order_id);
+        }
+    }
+
+    if (track_changes_) {
+        set_change_tracking(true);
+    }
+    return position;
+}
+
+// BackgroundCheckpointer implementation
+
+BackgroundCheckpointer::~BackgroundCheckpointer() {
+    wait();
+}
+
+bool BackgroundCheckpointer::start(const Orderbook& book, const std::string& path,
+                                   const CheckpointPosition& position) {
+    if (!poll()) {
+        stats_.skipped++;
+        return false;
+    }
+    
+    const auto begin = std::chrono::steady_clock::now();
+#ifdef ORDERBOOK_HAVE_FORK
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        // Child: serialize the copy-on-write view and leave without running
+        // the parent's destructors or flushing its stream buffers
+        int status = 0;
+        try {
+            book.save_checkpoint(path, position);
+        } catch (...) {
+            status = 1;
+        }
+        ::_exit(status);
+    }
+    if (pid < 0) {
+        throw std::runtime_error("Cannot fork checkpoint writer");
+    }
+    child_ = pid;
+#else
+    book.save_checkpoint(path, position);
+#endif
+    const auto pause = std::chrono::duration_cast<duration_t>(std::chrono::steady_clock::now() - begin);
+    
+    stats_.started++;
+    stats_.last_pause = pause;
+    stats_.max_pause = std::max(stats_.max_pause, pause);
+    stats_.total_pause += pause;
+    started_at_ = begin;
+#ifndef ORDERBOOK_HAVE_FORK
+    reaped(0);
+#endif
+    return true;
+}
+
+bool BackgroundCheckpointer::poll() {
+#ifdef ORDERBOOK_HAVE_FORK
+    if (child_ > 0) {
+        int status = 0;
+        if (::waitpid(child_, &status, WNOHANG) == 0) {
+            return false;
+        }
+        reaped(status);
+    }
+#endif
+    return true;
+}
+
+void BackgroundCheckpointer::wait() {
+#ifdef ORDERBOOK_HAVE_FORK
+    if (child_ > 0) {
+        int status = 0;
+        ::waitpid(child_, &status, 0);
+        reaped(status);
+    }
+#endif
+}
+
+void BackgroundCheckpointer::reaped(int status) {
+#ifdef ORDERBOOK_HAVE_FORK
+    const bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    const bool ok = status == 0;
+#endif
+    child_ = -1;
+    (ok ? stats_.completed : stats_.failed)++;
+    stats_.max_write = std::max(stats_.max_write,
+        std::chrono::duration_cast<duration_t>(std::chrono::steady_clock::now() - started_at_));
+}
+
+} // namespace orderbook
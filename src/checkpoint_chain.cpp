@@ -0,0 +1,174 @@
+#include "checkpoint_chain.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace orderbook {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* FULL_SUFFIX = ".full";
+constexpr const char* DELTA_SUFFIX = ".delta";
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+CheckpointChain::CheckpointChain(std::string prefix, std::size_t full_every)
+    : prefix_(std::move(prefix)), full_every_(std::max<std::size_t>(full_every, 1)) {
+    const fs::path prefix_path(prefix_);
+    const fs::path dir = prefix_path.parent_path().empty() ? fs::path(".") : prefix_path.parent_path();
+    const std::string stem = prefix_path.filename().string() + ".";
+    if (!fs::is_directory(dir)) {
+        return;
+    }
+
+    // <stem><serial>.full / <stem><serial>.delta; anything else (including
+    // half-written .tmp files) is not part of the chain
+    for (const auto& file : fs::directory_iterator(dir)) {
+        const std::string name = file.path().filename().string();
+        if (name.compare(0, stem.size(), stem) != 0) {
+            continue;
+        }
+        const bool full = ends_with(name, FULL_SUFFIX);
+        if (!full && !ends_with(name, DELTA_SUFFIX)) {
+            continue;
+        }
+        const std::string serial = name.substr(stem.size(), name.rfind('.') - stem.size());
+        if (serial.empty() || !std::all_of(serial.begin(), serial.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            continue;
+        }
+
+        RestorePoint point;
+        point.serial = std::stoull(serial);
+        point.full = full;
+        point.path = file.path().string();
+        point.position = Orderbook::peek_checkpoint(point.path);
+        points_.push_back(std::move(point));
+    }
+    std::sort(points_.begin(), points_.end(),
+              [](const RestorePoint& lhs, const RestorePoint& rhs) { return lhs.serial < rhs.serial; });
+}
+
+const RestorePoint& CheckpointChain::save(Orderbook& book, const CheckpointPosition& position) {
+    const std::size_t deltas = points_.empty() ? 0 : points_.size() - 1 - base_of(points_.size() - 1);
+    const bool delta = !points_.empty() && tracked_ == &book && book.tracks_changes() &&
+                       deltas + 1 < full_every_;
+
+    RestorePoint point;
+    point.serial = points_.empty() ? 0 : points_.back().serial + 1;
+    point.full = !delta;
+    point.position = position;
+    point.path = path_for(point.serial, point.full);
+
+    if (delta) {
+        // Write-then-rename, like full images
+        const std::string temp_path = point.path + ".tmp";
+        {
+            std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+            if (!output.is_open()) {
+                throw std::runtime_error("Cannot open checkpoint file: " + temp_path);
+            }
+            book.save_delta(output, points_.back().position, position);
+        }
+        fs::rename(temp_path, point.path);
+    } else {
+        book.save_checkpoint(point.path, position);
+        book.set_change_tracking(true);
+    }
+
+    tracked_ = &book;
+    points_.push_back(std::move(point));
+    return points_.back();
+}
+
+CheckpointPosition CheckpointChain::restore(Orderbook& book, std::size_t point) {
+    if (point >= points_.size()) {
+        throw std::runtime_error("No restore point " + std::to_string(point) + " in " + prefix_);
+    }
+    const CheckpointPosition position = rebuild(book, point);
+
+    if (point + 1 == points_.size()) {
+        book.set_change_tracking(true);
+        tracked_ = &book;
+    } else if (tracked_ == &book) {
+        tracked_ = nullptr;
+    }
+    return position;
+}
+
+CheckpointPosition CheckpointChain::restore_latest(Orderbook& book) {
+    if (points_.empty()) {
+        throw std::runtime_error("No restore points in " + prefix_);
+    }
+    return restore(book, points_.size() - 1);
+}
+
+void CheckpointChain::compact(std::size_t keep) {
+    keep = std::max<std::size_t>(keep, 1);
+    if (points_.size() <= keep) {
+        return;
+    }
+    const std::size_t first = points_.size() - keep;
+
+    // Fold the first kept point into a full image (a scratch book, so the
+    // tracked book and its pending delta are unaffected)
+    RestorePoint& oldest = points_[first];
+    if (!oldest.full) {
+        Orderbook scratch;
+        const CheckpointPosition position = rebuild(scratch, first);
+        const std::string full_path = path_for(oldest.serial, true);
+        scratch.save_checkpoint(full_path, position);
+        fs::remove(oldest.path);
+        oldest.full = true;
+        oldest.path = full_path;
+    }
+
+    for (std::size_t i = 0; i < first; ++i) {
+        fs::remove(points_[i].path);
+    }
+    points_.erase(points_.begin(), points_.begin() + static_cast<std::ptrdiff_t>(first));
+}
+
+std::uint64_t CheckpointChain::disk_bytes() const {
+    std::uint64_t bytes = 0;
+    for (const auto& point : points_) {
+        bytes += fs::file_size(point.path);
+    }
+    return bytes;
+}
+
+CheckpointPosition CheckpointChain::rebuild(Orderbook& book, std::size_t point) const {
+    const std::size_t base = base_of(point);
+    CheckpointPosition position = book.load_checkpoint(points_[base].path);
+    for (std::size_t i = base + 1; i <= point; ++i) {
+        std::ifstream input(points_[i].path, std::ios::binary);
+        if (!input.is_open()) {
+            throw std::runtime_error("Cannot open checkpoint file: " + points_[i].path);
+        }
+        position = book.apply_delta(input, position);
+    }
+    return position;
+}
+
+std::string CheckpointChain::path_for(std::uint64_t serial, bool full) const {
+    return prefix_ + "." + std::to_string(serial) + (full ? FULL_SUFFIX : DELTA_SUFFIX);
+}
+
+std::size_t CheckpointChain::base_of(std::size_t point) const {
+    for (std::size_t i = point + 1; i-- > 0;) {
+        if (points_[i].full) {
+            return i;
+        }
+    }
+    throw std::runtime_error("No full image before restore point " + std::to_string(point) + " in " + prefix_);
+}
+
+} // namespace orderbook
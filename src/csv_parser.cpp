@@ -4,6 +4,8 @@
 #include <cstring>
 #include <algorithm>
 #include <charconv>
+#include <cmath>
+#include <ctime>
 // SIMD operations - conditional include for x86/x64 only
 #ifdef __x86_64__
 #include <immintrin.h>
@@ -157,8 +159,8 @@ timestamp_t CSVParser::parse_timestamp(const std::string& str) {
     tm.tm_min = (str[14] - '0') * 10 + (str[15] - '0');
     tm.tm_sec = (str[17] - '0') * 10 + (str[18] - '0');
     
-    // Convert to time_t
-    std::time_t time = std::mktime(&tm);
+    // Convert to time_t (timestamps are UTC)
+    std::time_t time = timegm(&tm);
     
     // Parse nanoseconds
     timestamp_t nanoseconds = 0;
@@ -177,14 +179,90 @@ timestamp_t CSVParser::parse_timestamp(const std::string& str) {
     return static_cast<timestamp_t>(time) * 1000000000 + nanoseconds;
 }
 
+std::optional<timestamp_t> CSVParser::parse_time_argument(const std::string& str) {
+    auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+    auto number = [&](std::size_t pos, std::size_t count) -> std::optional<int> {
+        int value = 0;
+        for (std::size_t i = pos; i < pos + count; ++i) {
+            if (!is_digit(str[i])) {
+                return std::nullopt;
+            }
+            value = value * 10 + (str[i] - '0');
+        }
+        return value;
+    };
+    
+    // Nanoseconds since epoch
+    if (!str.empty() && std::all_of(str.begin(), str.end(), is_digit)) {
+        timestamp_t ts = 0;
+        const auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), ts);
+        if (error != std::errc{} || end != str.data() + str.size()) {
+            return std::nullopt;
+        }
+        return ts;
+    }
+    
+    // YYYY-MM-DDTHH:MM:SS
+    if (str.size() < 19 || str[4] != '-' || str[7] != '-' || str[10] != 'T' || str[13] != ':' || str[16] != ':') {
+        return std::nullopt;
+    }
+    const auto year = number(0, 4);
+    const auto month = number(5, 2);
+    const auto day = number(8, 2);
+    const auto hour = number(11, 2);
+    const auto minute = number(14, 2);
+    const auto second = number(17, 2);
+    if (!year || !month || !day || !hour || !minute || !second || *month < 1 || *month > 12 || *day < 1 ||
+        *day > 31 || *hour > 23 || *minute > 59 || *second > 59) {
+        return std::nullopt;
+    }
+    
+    // Optional .f to .fffffffff, scaled to nanoseconds, then optional 'Z'
+    std::size_t pos = 19;
+    timestamp_t nanoseconds = 0;
+    if (pos < str.size() && str[pos] == '.') {
+        const std::size_t digits_begin = ++pos;
+        while (pos < str.size() && is_digit(str[pos])) {
+            nanoseconds = nanoseconds * 10 + (str[pos++] - '0');
+        }
+        const std::size_t digits = pos - digits_begin;
+        if (digits == 0 || digits > 9) {
+            return std::nullopt;
+        }
+        for (std::size_t i = digits; i < 9; ++i) {
+            nanoseconds *= 10;
+        }
+    }
+    if (pos < str.size() && str[pos] == 'Z') {
+        ++pos;
+    }
+    if (pos != str.size()) {
+        return std::nullopt;
+    }
+    
+    std::tm tm = {};
+    tm.tm_year = *year - 1900;
+    tm.tm_mon = *month - 1;
+    tm.tm_mday = *day;
+    tm.tm_hour = *hour;
+    tm.tm_min = *minute;
+    tm.tm_sec = *second;
+    const std::time_t time = timegm(&tm);
+    if (tm.tm_mday != *day) {
+        return std::nullopt;  // timegm normalised a day past the month's end
+    }
+    return static_cast<timestamp_t>(time) * 1000000000 + nanoseconds;
+}
+
 price_t CSVParser::parse_price(const std::string& str) {
     if (str.empty()) {
         return 0;
     }
     
     // Parse price as fixed-point with 6 decimal places
+    // Round rather than truncate: 2.01 * 1e6 is 2009999.99... in binary
     double price = std::stod(str);
-    return static_cast<price_t>(price * PRICE_SCALE);
+    return static_cast<price_t>(std::llround(price * PRICE_SCALE));
 }
 
 Action CSVParser::parse_action(char action) {
@@ -193,7 +271,8 @@ Action CSVParser::parse_action(char action) {
         case 'C': return Action::CANCEL;
         case 'T': return Action::TRADE;
         case 'F': return Action::FILL;
-        case 'R': return Action::REPLACE;
+        case 'M': return Action::MODIFY;
+        case 'R': return Action::CLEAR;
         default: return Action::ADD;  // Default fallback
     }
 }
@@ -212,7 +291,9 @@ std::string CSVParser::format_timestamp(timestamp_t ts) {
     std::time_t seconds = ts / 1000000000;
     timestamp_t nanoseconds = ts % 1000000000;
     
-    std::tm* tm = std::gmtime(&seconds);
+    // gmtime_r: rows are formatted concurrently by multi-threaded consumers
+    std::tm tm_storage {};
+    std::tm* tm = gmtime_r(&seconds, &tm_storage);
     if (!tm) {
         return "1970-01-01T00:00:00.000000000Z";
     }
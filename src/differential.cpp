@@ -0,0 +1,416 @@
+#include "differential.hpp"
+#include "market_generator.hpp"
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+namespace orderbook {
+
+namespace {
+
+template<typename T>
+void compare_field(std::ostringstream& out, const char* name, const T& expected, const T& actual) {
+    if (out.tellp() == 0 && !(expected == actual)) {
+        out << name << ": expected " << expected << ", got " << actual;
+    }
+}
+
+std::string describe_record(const MBORecord& record) {
+    std::ostringstream out;
+    out << static_cast<char>(record.action) << " " << static_cast<char>(record.side)
+        << " id=" << record.order_id << " px=" << record.price << " sz=" << record.size;
+    return out.str();
+}
+
+// Parse outcome including exceptions, so "throws" vs "rejects" is a difference too
+struct ParseOutcome {
+    std::optional<MBORecord> record;
+    std::optional<std::string> exception;
+};
+
+ParseOutcome run_parser(const LineParserInfo& parser, const std::string& line) {
+    ParseOutcome outcome;
+    try {
+        outcome.record = parser.parse(line);
+    } catch (const std::exception& e) {
+        outcome.exception = e.what();
+    } catch (...) {
+        outcome.exception = "unknown exception";
+    }
+    return outcome;
+}
+
+std::string describe_outcome(const ParseOutcome& outcome) {
+    if (outcome.exception) {
+        return "throws (" + *outcome.exception + ")";
+    }
+    return outcome.record ? "accepts" : "rejects";
+}
+
+std::optional<std::string> apply_both(BookEngine& reference, BookEngine& candidate, const MBORecord& record) {
+    std::optional<std::string> reference_error;
+    std::optional<std::string> candidate_error;
+    try {
+        reference.apply(record);
+    } catch (const std::exception& e) {
+        reference_error = e.what();
+    }
+    try {
+        candidate.apply(record);
+    } catch (const std::exception& e) {
+        candidate_error = e.what();
+    }
+    if (reference_error != candidate_error) {
+        return "apply: reference " + (reference_error ? "throws (" + *reference_error + ")" : std::string("succeeds")) +
+               ", candidate " + (candidate_error ? "throws (" + *candidate_error + ")" : std::string("succeeds"));
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> diff_state(const BookEngine& reference, const BookEngine& candidate, order_id_t order_id) {
+    for (Side side : {Side::BID, Side::ASK}) {
+        const auto expected = reference.top_levels(side);
+        const auto actual = candidate.top_levels(side);
+        for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
+            if (expected[i] != actual[i]) {
+                std::ostringstream out;
+                out << (side == Side::BID ? "bid" : "ask") << " level " << i << ": expected "
+                    << expected[i].price << " x " << expected[i].size << " (" << expected[i].count << "), got "
+                    << actual[i].price << " x " << actual[i].size << " (" << actual[i].count << ")";
+                return out.str();
+            }
+        }
+    }
+
+    if (reference.order_count() != candidate.order_count()) {
+        return "order_count: expected " + std::to_string(reference.order_count()) +
+               ", got " + std::to_string(candidate.order_count());
+    }
+
+    const auto expected = reference.find_order(order_id);
+    const auto actual = candidate.find_order(order_id);
+    if (expected.has_value() != actual.has_value() ||
+        (expected && (expected->side != actual->side || expected->price != actual->price ||
+                      expected->size != actual->size))) {
+        std::ostringstream out;
+        out << "find_order(" << order_id << "): expected ";
+        if (expected) {
+            out << static_cast<char>(expected->side) << " " << expected->price << " x " << expected->size;
+        } else {
+            out << "none";
+        }
+        out << ", got ";
+        if (actual) {
+            out << static_cast<char>(actual->side) << " " << actual->price << " x " << actual->size;
+        } else {
+            out << "none";
+        }
+        return out.str();
+    }
+    return std::nullopt;
+}
+
+std::string stream_to_csv(const std::vector<MBORecord>& records) {
+    std::string csv;
+    for (const auto& record : records) {
+        csv += MarketGenerator::format_mbo_line(record);
+        csv += '\n';
+    }
+    return csv;
+}
+
+std::vector<std::string> split_fields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    while (true) {
+        const std::size_t comma = line.find(',', start);
+        fields.push_back(line.substr(start, comma - start));
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return fields;
+}
+
+std::string join_fields(const std::vector<std::string>& fields) {
+    std::string line;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        if (i) {
+            line += ',';
+        }
+        line += fields[i];
+    }
+    return line;
+}
+
+// Candidates default to every registered entry except the reference; with
+// none registered the reference is checked against a fresh copy of itself
+template<typename Info>
+std::vector<Info> select_candidates(const std::vector<Info>& registered, const std::vector<std::string>& names) {
+    std::vector<Info> candidates;
+    for (std::size_t i = 0; i < registered.size(); ++i) {
+        const bool wanted = names.empty() ? i > 0 :
+            std::find(names.begin(), names.end(), registered[i].name) != names.end();
+        if (wanted) {
+            candidates.push_back(registered[i]);
+        }
+    }
+    if (candidates.empty() && names.empty() && !registered.empty()) {
+        candidates.push_back(registered.front());
+    }
+    return candidates;
+}
+
+} // namespace
+
+std::optional<std::string> diff_records(const MBORecord& expected, const MBORecord& actual) {
+    std::ostringstream out;
+    compare_field(out, "ts_recv", expected.timestamp.ts_recv, actual.timestamp.ts_recv);
+    compare_field(out, "ts_event", expected.timestamp.ts_event, actual.timestamp.ts_event);
+    compare_field(out, "rtype", static_cast<std::uint16_t>(expected.rtype), static_cast<std::uint16_t>(actual.rtype));
+    compare_field(out, "publisher_id", expected.publisher_id, actual.publisher_id);
+    compare_field(out, "instrument_id", expected.instrument_id, actual.instrument_id);
+    compare_field(out, "action", static_cast<char>(expected.action), static_cast<char>(actual.action));
+    compare_field(out, "side", static_cast<char>(expected.side), static_cast<char>(actual.side));
+    compare_field(out, "price", expected.price, actual.price);
+    compare_field(out, "size", expected.size, actual.size);
+    compare_field(out, "channel_id", expected.channel_id, actual.channel_id);
+    compare_field(out, "order_id", expected.order_id, actual.order_id);
+    compare_field(out, "flags", expected.flags, actual.flags);
+    compare_field(out, "ts_in_delta", expected.ts_in_delta, actual.ts_in_delta);
+    compare_field(out, "sequence", expected.sequence, actual.sequence);
+    compare_field(out, "symbol", expected.symbol, actual.symbol);
+    if (out.tellp() == 0) {
+        return std::nullopt;
+    }
+    return out.str();
+}
+
+std::optional<std::string> diff_parse(const LineParserInfo& reference, const LineParserInfo& candidate,
+                                      const std::string& line) {
+    const ParseOutcome expected = run_parser(reference, line);
+    const ParseOutcome actual = run_parser(candidate, line);
+
+    if (expected.exception || actual.exception || expected.record.has_value() != actual.record.has_value()) {
+        if (describe_outcome(expected) == describe_outcome(actual)) {
+            return std::nullopt;
+        }
+        return "reference " + describe_outcome(expected) + ", candidate " + describe_outcome(actual);
+    }
+    if (!expected.record) {
+        return std::nullopt;
+    }
+    return diff_records(*expected.record, *actual.record);
+}
+
+std::optional<std::string> diff_books(const BookEngineFactory& reference, const BookEngineFactory& candidate,
+                                      const std::vector<MBORecord>& records) {
+    auto expected = reference();
+    auto actual = candidate();
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        auto mismatch = apply_both(*expected, *actual, records[i]);
+        if (!mismatch) {
+            mismatch = diff_state(*expected, *actual, records[i].order_id);
+        }
+        if (mismatch) {
+            return "after record " + std::to_string(i) + " (" + describe_record(records[i]) + "): " + *mismatch;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string minimize_line(const std::string& line, const std::function<bool(const std::string&)>& still_fails) {
+    const std::vector<char> minimized = minimize<char>(
+        std::vector<char>(line.begin(), line.end()),
+        [&](const std::vector<char>& chars) { return still_fails(std::string(chars.begin(), chars.end())); });
+    return std::string(minimized.begin(), minimized.end());
+}
+
+std::string MboFuzzer::mutate_line(const std::string& line, std::size_t max_mutations) {
+    static const std::string alphabet = "0123456789,.-+:TZACFRNBe x";
+    static const char* const special_values[] = {
+        "", "0", "-1", "+5", " 1", "1e308", "nan", "inf", "0x10", "abc",
+        "4294967296", "18446744073709551616", "99999999999999999999",
+        "2025-13-45T99:99:99.999999999Z", "2025-07-17T07:05:09Z",
+    };
+
+    std::string mutated = line;
+    const std::size_t mutations = 1 + below(std::max<std::size_t>(max_mutations, 1));
+    for (std::size_t m = 0; m < mutations; ++m) {
+        std::vector<std::string> fields;
+        switch (below(8)) {
+            case 0:  // Overwrite a byte
+                if (!mutated.empty()) {
+                    mutated[below(mutated.size())] = alphabet[below(alphabet.size())];
+                }
+                break;
+            case 1:  // Delete a byte
+                if (!mutated.empty()) {
+                    mutated.erase(below(mutated.size()), 1);
+                }
+                break;
+            case 2:  // Insert a byte
+                mutated.insert(mutated.begin() + static_cast<std::ptrdiff_t>(below(mutated.size() + 1)),
+                               alphabet[below(alphabet.size())]);
+                break;
+            case 3:  // Drop a field
+                fields = split_fields(mutated);
+                fields.erase(fields.begin() + static_cast<std::ptrdiff_t>(below(fields.size())));
+                mutated = join_fields(fields);
+                break;
+            case 4:  // Duplicate a field
+                fields = split_fields(mutated);
+                {
+                    const std::size_t index = below(fields.size());
+                    fields.insert(fields.begin() + static_cast<std::ptrdiff_t>(index), fields[index]);
+                }
+                mutated = join_fields(fields);
+                break;
+            case 5:  // Replace a field with an edge-case value
+                fields = split_fields(mutated);
+                fields[below(fields.size())] = special_values[below(std::size(special_values))];
+                mutated = join_fields(fields);
+                break;
+            case 6:  // Truncate
+                mutated.resize(below(mutated.size() + 1));
+                break;
+            default:  // Swap two fields
+                fields = split_fields(mutated);
+                std::swap(fields[below(fields.size())], fields[below(fields.size())]);
+                mutated = join_fields(fields);
+                break;
+        }
+    }
+    return mutated;
+}
+
+std::vector<MBORecord> MboFuzzer::mutate_stream(std::vector<MBORecord> records, double mutation_rate) {
+    static const Action actions[] = {Action::ADD, Action::CANCEL, Action::TRADE, Action::FILL, Action::MODIFY};
+    const auto threshold = static_cast<std::uint64_t>(mutation_rate * 1000000.0);
+
+    std::vector<MBORecord> mutated;
+    mutated.reserve(records.size() + records.size() / 10);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        MBORecord record = records[i];
+        if (rng_() % 1000000 >= threshold) {
+            mutated.push_back(std::move(record));
+            continue;
+        }
+        switch (below(9)) {
+            case 0:  // Duplicate
+                mutated.push_back(record);
+                break;
+            case 1:  // Drop
+                continue;
+            case 2:  // Swap with the next record
+                if (i + 1 < records.size()) {
+                    std::swap(records[i + 1], record);
+                }
+                break;
+            case 3:  // Unknown order id
+                record.order_id = (1ull << 40) + below(1000);
+                break;
+            case 4:
+                record.size = 0;
+                break;
+            case 5:  // Oversize cancel or fill
+                record.size = record.size * 3 + 1;
+                break;
+            case 6:
+                record.side = Side::NEUTRAL;
+                break;
+            case 7:
+                record.action = actions[below(std::size(actions))];
+                break;
+            default:  // Move the price a few ticks
+                record.price += static_cast<price_t>(below(11)) * 10000 - 50000;
+                break;
+        }
+        mutated.push_back(std::move(record));
+    }
+    return mutated;
+}
+
+DifferentialReport run_differential(const DifferentialConfig& config) {
+    const auto parsers = select_candidates(registered_line_parsers(), config.parsers);
+    const auto engines = select_candidates(registered_book_engines(), config.engines);
+    return run_differential(config, registered_line_parsers().front(), parsers,
+                            registered_book_engines().front(), engines);
+}
+
+DifferentialReport run_differential(const DifferentialConfig& config,
+                                    const LineParserInfo& reference_parser,
+                                    const std::vector<LineParserInfo>& candidate_parsers,
+                                    const BookEngineInfo& reference_engine,
+                                    const std::vector<BookEngineInfo>& candidate_engines) {
+    DifferentialReport report;
+    MboFuzzer fuzzer(config.seed);
+    auto full = [&] { return report.failures.size() >= config.max_failures; };
+
+    // Parsers: every generated line as-is and fuzzed
+    std::vector<bool> parser_failed(candidate_parsers.size(), false);
+    MarketGeneratorConfig line_config;
+    line_config.seed = config.seed;
+    line_config.instrument_count = 3;
+    line_config.channel_count = 2;
+    line_config.trade_probability = 0.1;
+    MarketGenerator line_generator(line_config);
+
+    for (std::size_t i = 0; i < config.lines && !full(); ++i) {
+        const std::string valid = MarketGenerator::format_mbo_line(line_generator.next());
+        const std::string fuzzed = fuzzer.mutate_line(valid);
+        for (const std::string* line : {&valid, &fuzzed}) {
+            ++report.parser_cases;
+            for (std::size_t c = 0; c < candidate_parsers.size() && !full(); ++c) {
+                if (parser_failed[c] || !diff_parse(reference_parser, candidate_parsers[c], *line)) {
+                    continue;
+                }
+                parser_failed[c] = true;
+                const std::string minimized = minimize_line(*line, [&](const std::string& candidate_line) {
+                    return diff_parse(reference_parser, candidate_parsers[c], candidate_line).has_value();
+                });
+                report.failures.push_back({"parser", candidate_parsers[c].name,
+                                           *diff_parse(reference_parser, candidate_parsers[c], minimized),
+                                           minimized, line->size(), minimized.size()});
+            }
+        }
+    }
+
+    // Engines: generated streams of varying shape, every other one fuzzed
+    std::vector<bool> engine_failed(candidate_engines.size(), false);
+    std::mt19937_64 shape_rng(config.seed ^ 0x9e3779b97f4a7c15ull);
+    for (std::size_t s = 0; s < config.streams && !full(); ++s) {
+        MarketGeneratorConfig stream_config;
+        stream_config.seed = config.seed * 1000003 + s;
+        stream_config.target_resting_orders = 10 + shape_rng() % 500;
+        stream_config.mean_level_distance = 1.0 + static_cast<double>(shape_rng() % 20);
+        stream_config.trade_probability = static_cast<double>(shape_rng() % 30) / 100.0;
+        stream_config.max_sweep_levels = 1 + static_cast<std::uint32_t>(shape_rng() % 6);
+        MarketGenerator generator(stream_config);
+
+        std::vector<MBORecord> records = generator.generate(config.stream_length);
+        if (s % 2 == 1) {
+            records = fuzzer.mutate_stream(std::move(records));
+        }
+        ++report.engine_streams;
+        report.engine_records += records.size();
+
+        for (std::size_t c = 0; c < candidate_engines.size() && !full(); ++c) {
+            if (engine_failed[c] || !diff_books(reference_engine.create, candidate_engines[c].create, records)) {
+                continue;
+            }
+            engine_failed[c] = true;
+            const std::vector<MBORecord> minimized = minimize<MBORecord>(
+                records, [&](const std::vector<MBORecord>& subset) {
+                    return diff_books(reference_engine.create, candidate_engines[c].create, subset).has_value();
+                });
+            report.failures.push_back({"engine", candidate_engines[c].name,
+                                       *diff_books(reference_engine.create, candidate_engines[c].create, minimized),
+                                       stream_to_csv(minimized), records.size(), minimized.size()});
+        }
+    }
+    return report;
+}
+
+} // namespace orderbook
@@ -0,0 +1,262 @@
+#include "feed_arbiter.hpp"
+#include "orderbook.hpp"
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <stdexcept>
+
+namespace orderbook {
+
+// SequenceWindow implementation
+
+SequenceWindow::SequenceWindow(std::size_t capacity)
+    : bits_(std::bit_ceil(std::max<std::size_t>(capacity, 64)) / 64, 0) {}
+
+bool SequenceWindow::contains(sequence_t sequence) const noexcept {
+    if (!started_ || sequence - base_ >= capacity()) {
+        return started_ && sequence < base_;  // Slid out counts as delivered
+    }
+    const std::size_t bit = sequence & (capacity() - 1);
+    return (bits_[bit / 64] >> (bit % 64)) & 1;
+}
+
+bool SequenceWindow::mark(sequence_t sequence) {
+    if (!started_) {
+        // Leave half the window for the other line's older sequences
+        base_ = sequence - std::min<sequence_t>(sequence, capacity() / 2);
+        started_ = true;
+    }
+    if (sequence < base_) {
+        return false;
+    }
+    if (sequence - base_ >= capacity()) {
+        slide_to(sequence - capacity() + 1);
+    }
+
+    const std::size_t bit = sequence & (capacity() - 1);
+    std::uint64_t& word = bits_[bit / 64];
+    const std::uint64_t mask = std::uint64_t{1} << (bit % 64);
+    if (word & mask) {
+        return false;
+    }
+    word |= mask;
+    return true;
+}
+
+void SequenceWindow::slide_to(sequence_t base) {
+    if (base - base_ >= capacity()) {
+        std::fill(bits_.begin(), bits_.end(), 0);
+    } else {
+        for (sequence_t sequence = base_; sequence < base; ++sequence) {
+            const std::size_t bit = sequence & (capacity() - 1);
+            bits_[bit / 64] &= ~(std::uint64_t{1} << (bit % 64));
+        }
+    }
+    base_ = base;
+}
+
+// FeedArbiter implementation
+
+FeedArbiter::FeedArbiter(const std::string& line_a, const std::string& line_b, std::size_t window)
+    : window_(window) {
+    for (const std::string* path : {&line_a, &line_b}) {
+        auto input = std::make_unique<std::ifstream>(*path);
+        if (!input->is_open()) {
+            throw std::runtime_error("Cannot open input file: " + *path);
+        }
+        inputs_[owned_.size()] = input.get();
+        owned_.push_back(std::move(input));
+    }
+}
+
+FeedArbiter::FeedArbiter(std::istream& line_a, std::istream& line_b, std::size_t window)
+    : window_(window)
+    , inputs_{&line_a, &line_b} {}
+
+void FeedArbiter::refill(std::size_t line) {
+    heads_[line].reset();
+    if (!inputs_[line]) {
+        return;
+    }
+    // Skips headers and malformed lines
+    while (std::getline(*inputs_[line], line_)) {
+        if (auto record = CSVParser::parse_mbo_line(line_)) {
+            stats_.read[line]++;
+            heads_[line] = std::move(record);
+            return;
+        }
+    }
+    inputs_[line] = nullptr;
+}
+
+bool FeedArbiter::arrives_first(const MBORecord& b, const MBORecord& a) noexcept {
+    // Earliest ts_recv; on a tie the lower sequence of the same channel, else A
+    if (b.timestamp.ts_recv != a.timestamp.ts_recv) {
+        return b.timestamp.ts_recv < a.timestamp.ts_recv;
+    }
+    return b.publisher_id == a.publisher_id && b.channel_id == a.channel_id && b.sequence != 0 &&
+           a.sequence != 0 && b.sequence < a.sequence;
+}
+
+std::optional<MBORecord> FeedArbiter::next() {
+    for (;;) {
+        if (!ready_.empty()) {
+            std::optional<MBORecord> record = std::move(ready_.front());
+            ready_.pop_front();
+            return record;
+        }
+        for (std::size_t line = 0; line < 2; ++line) {
+            if (!heads_[line] && inputs_[line]) {
+                refill(line);
+            }
+        }
+        if (!heads_[0] && !heads_[1]) {
+            // Nothing left to fill a gap with
+            for (ChannelState& channel : channels_) {
+                release(channel, true);
+            }
+            if (ready_.empty()) {
+                return std::nullopt;
+            }
+            continue;
+        }
+
+        const std::size_t line = !heads_[0] || (heads_[1] && arrives_first(*heads_[1], *heads_[0])) ? 1 : 0;
+        MBORecord record = std::move(*heads_[line]);
+        heads_[line].reset();
+        const bool accepted = accept(line, record);
+        ChannelState& channel = channel_of(record);
+        if (accepted) {
+            hold(channel, std::move(record));
+        } else if (!channel.held.empty()) {
+            // A dropped copy still moves its line past the gap
+            release(channel, false);
+        }
+    }
+}
+
+void FeedArbiter::hold(ChannelState& channel, MBORecord record) {
+    const sequence_t sequence = record.sequence;
+    if (channel.held.empty() && (sequence == 0 || !channel.started || sequence <= channel.released + 1)) {
+        if (sequence != 0) {
+            channel.released = channel.started ? std::max(channel.released, sequence) : sequence;
+            channel.started = true;
+        }
+        ready_.push_back(std::move(record));
+        return;
+    }
+
+    // Unsequenced records stay after the newest sequence read before them
+    const sequence_t key = sequence != 0 ? sequence : std::max(channel.released, channel.held.back().key);
+    if (sequence == 0 || key > channel.released + 1) {
+        stats_.held++;
+    }
+    auto position = std::upper_bound(channel.held.begin(), channel.held.end(), key,
+                                     [](sequence_t lhs, const Held& rhs) { return lhs < rhs.key; });
+    channel.held.insert(position, Held{key, std::move(record)});
+    release(channel, false);
+}
+
+void FeedArbiter::release(ChannelState& channel, bool flush) {
+    while (!channel.held.empty()) {
+        Held& front = channel.held.front();
+        if (front.record.sequence != 0) {
+            if (front.key > channel.released + 1) {
+                if (!flush && !gap_dead(channel)) {
+                    return;
+                }
+                stats_.gaps += front.key - channel.released - 1;
+            }
+            channel.released = std::max(channel.released, front.key);
+        }
+        ready_.push_back(std::move(front.record));
+        channel.held.pop_front();
+    }
+}
+
+bool FeedArbiter::gap_dead(const ChannelState& channel) const noexcept {
+    if (channel.held.size() > std::max<std::size_t>(window_, 1)) {
+        return true;
+    }
+    // Each line delivers a channel in sequence order, so a line that has
+    // read past the missing sequence (or ended) will not supply it
+    const sequence_t missing = channel.released + 1;
+    for (std::size_t line = 0; line < 2; ++line) {
+        const bool live = inputs_[line] || heads_[line];
+        if (live && channel.last_read[line] <= missing) {
+            return false;
+        }
+    }
+    return true;
+}
+
+FeedArbiter::ChannelState& FeedArbiter::channel_of(const MBORecord& record) {
+    if (record.publisher_id >= slots_.size()) {
+        slots_.resize(static_cast<std::size_t>(record.publisher_id) + 1);
+    }
+    auto& channels = slots_[record.publisher_id];
+    if (record.channel_id >= channels.size()) {
+        channels.resize(static_cast<std::size_t>(record.channel_id) + 1, 0);
+    }
+    // Only the slot table grows with the ids; state is created for keys seen
+    std::uint32_t& slot = channels[record.channel_id];
+    if (slot == 0) {
+        channels_.emplace_back(window_);
+        slot = static_cast<std::uint32_t>(channels_.size());
+    }
+    return channels_[slot - 1];
+}
+
+bool FeedArbiter::accept(std::size_t line, const MBORecord& record) {
+    ChannelState& channel = channel_of(record);
+    if (record.sequence == 0) {
+        return accept_unsequenced(line, channel, record);
+    }
+    channel.last_read[line] = std::max(channel.last_read[line], record.sequence);
+
+    // New sequence: this line wins it. A known one passes only as the rest
+    // of a message the same line is still delivering.
+    const bool won = channel.delivered.mark(record.sequence) || channel.last_won[line] == record.sequence;
+    if (!won) {
+        stats_.duplicates++;
+        return false;
+    }
+    channel.last_won[line] = record.sequence;
+    stats_.delivered[line]++;
+    return true;
+}
+
+bool FeedArbiter::accept_unsequenced(std::size_t line, ChannelState& channel, const MBORecord& record) {
+    // Fields both lines carry unchanged (ts_recv and ts_in_delta differ)
+    std::uint64_t key = 0;
+    auto mix = [&key](std::uint64_t value) {
+        key ^= value + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    };
+    mix(static_cast<std::uint64_t>(record.timestamp.ts_event));
+    mix(static_cast<std::uint64_t>(record.action));
+    mix(static_cast<std::uint64_t>(record.side));
+    mix(static_cast<std::uint64_t>(record.price));
+    mix(record.size);
+    mix(record.order_id);
+    mix(record.flags);
+    mix(record.instrument_id);
+
+    auto [entry, added] = channel.unsequenced.try_emplace(key);
+    if (added) {
+        channel.unsequenced_order.push_back(key);
+        if (channel.unsequenced_order.size() > std::max<std::size_t>(window_, 1)) {
+            channel.unsequenced.erase(channel.unsequenced_order.front());
+            channel.unsequenced_order.pop_front();
+        }
+    }
+    UnsequencedCopies& copies = entry->second;
+    if (++copies.read[line] <= copies.delivered) {
+        stats_.duplicates++;
+        return false;
+    }
+    copies.delivered = copies.read[line];
+    stats_.delivered[line]++;
+    return true;
+}
+
+} // namespace orderbook
@@ -0,0 +1,45 @@
+#include "line_parser.hpp"
+#include "orderbook.hpp"
+#include <stdexcept>
+
+namespace orderbook {
+
+namespace {
+
+std::vector<LineParserInfo>& parser_registry() {
+    // Built-in parsers; the reference parser must stay first
+    static std::vector<LineParserInfo> registry = {
+        {"reference", "CSVParser::parse_mbo_line (field split + stoul/stod)",
+         [](const std::string& line) { return CSVParser::parse_mbo_line(line); }},
+    };
+    return registry;
+}
+
+} // namespace
+
+void register_line_parser(std::string name, std::string description, LineParser parser) {
+    auto& registry = parser_registry();
+    for (auto& info : registry) {
+        if (info.name == name) {
+            info.description = std::move(description);
+            info.parse = std::move(parser);
+            return;
+        }
+    }
+    registry.push_back({std::move(name), std::move(description), std::move(parser)});
+}
+
+const std::vector<LineParserInfo>& registered_line_parsers() {
+    return parser_registry();
+}
+
+const LineParserInfo& find_line_parser(const std::string& name) {
+    for (const auto& info : parser_registry()) {
+        if (info.name == name) {
+            return info;
+        }
+    }
+    throw std::invalid_argument("Unknown line parser: " + name);
+}
+
+} // namespace orderbook
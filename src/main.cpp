@@ -5,23 +5,152 @@
 #include <iomanip>
 #include <memory>
 #include <thread>
+#include <optional>
+
+namespace {
+
+// ISO 8601 UTC (second to nanosecond precision) or integer nanoseconds since epoch
+orderbook::timestamp_t parse_time(const std::string& value) {
+    const auto ts = orderbook::CSVParser::parse_time_argument(value);
+    if (!ts) {
+        throw std::invalid_argument("Cannot parse time: " + value);
+    }
+    return *ts;
+}
+
+} // namespace
 
 int main(int argc, char* argv[]) {
     try {
         // Parse command line arguments
-        if (argc != 2) {
-            std::cerr << "Usage: " << argv[0] << " <input_mbo_file.csv>\n";
+        if (argc < 2 || argv[1][0] == '-') {
+            std::cerr << "Usage: " << argv[0] << " <input_mbo_file.csv> [options]\n";
+            std::cerr << "  --output FILE            MBP output (default output_mbp.csv)\n";
+            std::cerr << "  --checkpoint FILE        Write a book checkpoint at end of input\n";
+            std::cerr << "  --checkpoint-every N     Also write it every N records\n";
+            std::cerr << "  --background-checkpoints Write periodic checkpoints from a forked child\n";
+            std::cerr << "  --resume FILE            Resume from a checkpoint instead of replaying\n";
+            std::cerr << "  --checkpoint-chain PATH  Restore points (full images and deltas) every\n";
+            std::cerr << "                           --checkpoint-every records, named PATH.<n>.*\n";
+            std::cerr << "  --full-every K           Full image every K restore points (default 16)\n";
+            std::cerr << "  --chain-keep N           Compact the chain to its newest N points\n";
+            std::cerr << "  --resume-chain PATH      Resume from the newest point of a chain\n";
+            std::cerr << "  --segments K             Two-phase parallel replay over K segments\n";
+            std::cerr << "  --threads N              Worker threads (default: hardware threads)\n";
+            std::cerr << "  --start TIME             Fast-forward (no output) until ts_event TIME\n";
+            std::cerr << "  --start-sequence N       Fast-forward until sequence N\n";
+            std::cerr << "  --state-only             Apply records without writing any rows\n";
+            std::cerr << "  --bulk-snapshots         Build snapshot recovery adds in one pass\n";
+            std::cerr << "  --event-batches          One row per matching event (F_LAST records only)\n";
+            std::cerr << "  --reorder N              Reorder input through a window of N records\n";
+            std::cerr << "  --reorder-ns NS          ... or of NS nanoseconds of ts_recv\n";
+            std::cerr << "  --reorder-key KEY        ts_recv (default) or sequence (one channel)\n";
+            std::cerr << "  --feed-b FILE            A/B arbitration: the input is line A, FILE line B\n";
+            std::cerr << "  --merge FILE             Merge FILE with the input by ts_recv (repeatable)\n";
             std::cerr << "Example: " << argv[0] << " mbo.csv\n";
             return 1;
         }
         
         std::string input_file = argv[1];
         std::string output_file = "output_mbp.csv";
+        std::string checkpoint_file;
+        std::string resume_file;
+        std::size_t checkpoint_every = 0;
+        std::string chain_prefix;
+        std::string resume_chain;
+        std::size_t full_every = 16;
+        std::size_t chain_keep = 0;
+        std::size_t segments = 0;
+        std::size_t threads = std::thread::hardware_concurrency();
+        std::optional<orderbook::timestamp_t> start_time_event;
+        std::optional<orderbook::sequence_t> start_sequence;
+        bool state_only = false;
+        bool background_checkpoints = false;
+        bool bulk_snapshots = false;
+        bool event_batches = false;
+        std::string feed_b;
+        std::vector<std::string> merge_inputs;
+        std::optional<orderbook::ReorderConfig> reorder;
+        auto reorder_config = [&]() -> orderbook::ReorderConfig& {
+            if (!reorder) {
+                reorder.emplace();
+                reorder->max_records = 0;
+            }
+            return *reorder;
+        };
+        
+        for (int i = 2; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--state-only") {
+                state_only = true;
+                continue;
+            }
+            if (arg == "--background-checkpoints") {
+                background_checkpoints = true;
+                continue;
+            }
+            if (arg == "--bulk-snapshots") {
+                bulk_snapshots = true;
+                continue;
+            }
+            if (arg == "--event-batches") {
+                event_batches = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << "\n";
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--output") {
+                output_file = value;
+            } else if (arg == "--checkpoint") {
+                checkpoint_file = value;
+            } else if (arg == "--checkpoint-every") {
+                checkpoint_every = std::stoull(value);
+            } else if (arg == "--resume") {
+                resume_file = value;
+            } else if (arg == "--checkpoint-chain") {
+                chain_prefix = value;
+            } else if (arg == "--full-every") {
+                full_every = std::stoull(value);
+            } else if (arg == "--chain-keep") {
+                chain_keep = std::stoull(value);
+            } else if (arg == "--resume-chain") {
+                resume_chain = value;
+            } else if (arg == "--segments") {
+                segments = std::stoull(value);
+            } else if (arg == "--feed-b") {
+                feed_b = value;
+            } else if (arg == "--merge") {
+                merge_inputs.push_back(value);
+            } else if (arg == "--reorder") {
+                reorder_config().max_records = std::stoull(value);
+            } else if (arg == "--reorder-ns") {
+                reorder_config().max_distance = std::stoull(value);
+            } else if (arg == "--reorder-key") {
+                if (value != "ts_recv" && value != "sequence") {
+                    std::cerr << "Unknown reorder key: " << value << "\n";
+                    return 1;
+                }
+                reorder_config().key = value == "sequence" ? orderbook::ReorderKey::SEQUENCE
+                                                           : orderbook::ReorderKey::TS_RECV;
+            } else if (arg == "--threads") {
+                threads = std::stoull(value);
+            } else if (arg == "--start") {
+                start_time_event = parse_time(value);
+            } else if (arg == "--start-sequence") {
+                start_sequence = std::stoull(value);
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                return 1;
+            }
+        }
         
         std::cout << "High-Performance Orderbook Reconstruction\n";
         std::cout << "========================================\n";
         std::cout << "Input file: " << input_file << "\n";
-        std::cout << "Output file: " << output_file << "\n";
+        std::cout << "Output file: " << (state_only ? "(state only)" : output_file) << "\n";
         std::cout << "Processing...\n\n";
         
         // Create processor with optimized settings
@@ -29,13 +158,43 @@ int main(int argc, char* argv[]) {
         
         // Set performance parameters
         processor.set_buffer_size(16384);  // Larger buffer for better performance
-        processor.set_thread_count(std::thread::hardware_concurrency());
+        processor.set_thread_count(threads);
+        
+        if (!checkpoint_file.empty()) {
+            processor.set_checkpoint_output(checkpoint_file, checkpoint_every);
+        }
+        if (!resume_file.empty()) {
+            processor.set_resume_checkpoint(resume_file);
+        }
+        if (!chain_prefix.empty()) {
+            processor.set_checkpoint_chain(chain_prefix, checkpoint_every, full_every, chain_keep);
+        }
+        if (!resume_chain.empty()) {
+            processor.set_resume_chain(resume_chain);
+        }
+        processor.set_output_start(start_time_event, start_sequence);
+        processor.set_state_only(state_only);
+        processor.set_background_checkpoints(background_checkpoints);
+        processor.set_bulk_snapshots(bulk_snapshots);
+        processor.set_event_batches(event_batches);
+        if (reorder) {
+            processor.set_reorder(*reorder);
+        }
         
         // Start performance monitoring
         auto start_time = std::chrono::high_resolution_clock::now();
         
         // Process the file
-        processor.process_file(input_file, output_file);
+        if (!feed_b.empty()) {
+            processor.process_feeds(input_file, feed_b, output_file);
+        } else if (!merge_inputs.empty()) {
+            merge_inputs.insert(merge_inputs.begin(), input_file);
+            processor.process_merged(merge_inputs, output_file);
+        } else if (segments > 0) {
+            processor.process_file_parallel(input_file, output_file, segments);
+        } else {
+            processor.process_file(input_file, output_file);
+        }
         
         auto end_time = std::chrono::high_resolution_clock::now();
         auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -59,7 +218,12 @@ int main(int argc, char* argv[]) {
                       << throughput << " records/second\n";
         }
         
-        std::cout << "\nOutput written to: " << output_file << "\n";
+        if (!state_only) {
+            std::cout << "\nOutput written to: " << output_file << "\n";
+        }
+        if (!checkpoint_file.empty()) {
+            std::cout << "Checkpoint written to: " << checkpoint_file << "\n";
+        }
         std::cout << "Processing completed successfully!\n";
         
         return 0;
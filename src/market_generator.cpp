@@ -0,0 +1,384 @@
+#include "market_generator.hpp"
+#include "orderbook.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace orderbook {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+Side opposite(Side side) noexcept {
+    return side == Side::BID ? Side::ASK : Side::BID;
+}
+
+} // namespace
+
+MarketGenerator::MarketGenerator(MarketGeneratorConfig config)
+    : config_(std::move(config))
+    , rng_(config_.seed)
+    , ts_event_(config_.start_time)
+    , ts_recv_(config_.start_time) {
+
+    const std::size_t count = std::max<std::size_t>(config_.instrument_count, 1);
+    const std::uint16_t channels = std::max<std::uint16_t>(config_.channel_count, 1);
+    const double mid_ticks = static_cast<double>(config_.initial_mid) /
+                             static_cast<double>(config_.tick_size);
+
+    instruments_.resize(count);
+    instrument_cdf_.reserve(count);
+
+    double total_weight = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& inst = instruments_[i];
+        inst.instrument_id = config_.first_instrument_id + static_cast<instrument_id_t>(i);
+        inst.channel_id = static_cast<std::uint16_t>(1 + i % channels);
+        inst.symbol = (count == 1) ? config_.symbol : config_.symbol + std::to_string(i);
+        inst.mid_ticks = mid_ticks;
+
+        total_weight += 1.0 / std::pow(static_cast<double>(i + 1), config_.instrument_skew);
+        instrument_cdf_.push_back(total_weight);
+    }
+    for (auto& weight : instrument_cdf_) {
+        weight /= total_weight;
+    }
+
+    channel_sequences_.assign(channels, 0);
+    initial_remaining_ = config_.initial_depth * count;
+}
+
+MBORecord MarketGenerator::next() {
+    while (pending_.empty()) {
+        generate_event();
+    }
+
+    MBORecord record = std::move(pending_.front());
+    pending_.pop_front();
+    return record;
+}
+
+std::vector<MBORecord> MarketGenerator::generate(std::size_t count) {
+    std::vector<MBORecord> records;
+    records.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        records.push_back(next());
+    }
+    return records;
+}
+
+void MarketGenerator::write_csv(std::ostream& output, std::size_t count, bool with_header) {
+    if (with_header) {
+        output << csv_header() << "\n";
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        output << format_mbo_line(next()) << "\n";
+    }
+}
+
+std::string MarketGenerator::csv_header() {
+    return "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,price,size,"
+           "channel_id,order_id,flags,ts_in_delta,sequence,symbol";
+}
+
+std::string MarketGenerator::format_mbo_line(const MBORecord& record) {
+    std::string line;
+    line.reserve(160);
+
+    line += CSVParser::format_timestamp(record.timestamp.ts_recv);
+    line += ',';
+    line += CSVParser::format_timestamp(record.timestamp.ts_event);
+    line += ',';
+    line += std::to_string(static_cast<std::uint16_t>(record.rtype));
+    line += ',';
+    line += std::to_string(record.publisher_id);
+    line += ',';
+    line += std::to_string(record.instrument_id);
+    line += ',';
+    line += static_cast<char>(record.action);
+    line += ',';
+    line += static_cast<char>(record.side);
+    line += ',';
+    line += CSVParser::format_price(record.price);
+    line += ',';
+    line += std::to_string(record.size);
+    line += ',';
+    line += std::to_string(record.channel_id);
+    line += ',';
+    line += std::to_string(record.order_id);
+    line += ',';
+    line += std::to_string(record.flags);
+    line += ',';
+    line += std::to_string(record.ts_in_delta);
+    line += ',';
+    line += std::to_string(record.sequence);
+    line += ',';
+    line += record.symbol;
+
+    return line;
+}
+
+void MarketGenerator::generate_event() {
+    advance_clock();
+
+    // Initial book build: adds round-robin across instruments
+    if (initial_remaining_ > 0) {
+        --initial_remaining_;
+        emit_add(instruments_[initial_cursor_++ % instruments_.size()]);
+        return;
+    }
+
+    auto& inst = instruments_[pick_instrument()];
+
+    // Drift the mid, keeping it clear of zero
+    inst.mid_ticks += normal() * config_.mid_volatility_ticks;
+    inst.mid_ticks = std::max(inst.mid_ticks, 2.0 + config_.mean_level_distance);
+
+    if (inst.live.empty()) {
+        emit_add(inst);
+        return;
+    }
+
+    if (uniform() < config_.trade_probability) {
+        emit_trade(inst);
+        return;
+    }
+
+    // Mean-reverting add/cancel mix: at the target size the ratio is cancel_to_add_ratio
+    const double target = static_cast<double>(std::max<std::size_t>(config_.target_resting_orders, 1));
+    const double fill = static_cast<double>(inst.live.size()) / target;
+    const double p_add = 1.0 / (1.0 + config_.cancel_to_add_ratio * fill);
+
+    if (uniform() < p_add) {
+        emit_add(inst);
+    } else {
+        emit_cancel(inst);
+    }
+}
+
+void MarketGenerator::emit_add(InstrumentState& inst) {
+    const Side side = (uniform() < 0.5) ? Side::BID : Side::ASK;
+    const price_t tick = config_.tick_size;
+    const auto distance = static_cast<price_t>(geometric(config_.mean_level_distance));
+
+    price_t price;
+    if (side == Side::BID) {
+        price = (static_cast<price_t>(std::ceil(inst.mid_ticks)) - 1 - distance) * tick;
+        if (!inst.asks.empty() && price >= inst.asks.begin()->first) {
+            price = inst.asks.begin()->first - tick;
+        }
+    } else {
+        price = (static_cast<price_t>(std::floor(inst.mid_ticks)) + 1 + distance) * tick;
+        if (!inst.bids.empty() && price <= inst.bids.begin()->first) {
+            price = inst.bids.begin()->first + tick;
+        }
+    }
+    price = std::max(price, tick);
+
+    const auto size = static_cast<size_t>(config_.lot_size * (1 + geometric(config_.mean_lots - 1.0)));
+    const order_id_t order_id = next_order_id_++;
+
+    insert_order(inst, order_id, side, price, size);
+
+    auto record = make_record(inst, Action::ADD, side, price, size, order_id);
+    record.flags = FLAG_LAST;
+    pending_.push_back(std::move(record));
+}
+
+void MarketGenerator::emit_cancel(InstrumentState& inst) {
+    const auto index = static_cast<std::size_t>(uniform() * static_cast<double>(inst.live.size()));
+    const order_id_t order_id = inst.live[std::min(index, inst.live.size() - 1)];
+    const GeneratedOrder order = inst.orders.at(order_id);
+
+    remove_order(inst, order_id);
+
+    auto record = make_record(inst, Action::CANCEL, order.side, order.price, order.size, order_id);
+    record.flags = FLAG_LAST;
+    pending_.push_back(std::move(record));
+}
+
+void MarketGenerator::emit_trade(InstrumentState& inst) {
+    const Side aggressor = (uniform() < 0.5) ? Side::BID : Side::ASK;
+    const auto quantity = static_cast<size_t>(config_.lot_size * (1 + geometric(config_.mean_lots * 2.0)));
+    const std::size_t before = pending_.size();
+
+    if (aggressor == Side::BID) {
+        sweep(inst, inst.asks, Side::ASK, quantity);
+    } else {
+        sweep(inst, inst.bids, Side::BID, quantity);
+    }
+
+    // Nothing to hit on that side: the order rests instead
+    if (pending_.size() == before) {
+        emit_add(inst);
+        return;
+    }
+
+    // Price impact: pull the mid towards the last traded price
+    inst.mid_ticks = 0.5 * (inst.mid_ticks + static_cast<double>(pending_.back().price) /
+                                             static_cast<double>(config_.tick_size));
+    pending_.back().flags |= FLAG_LAST;
+}
+
+template<typename Levels>
+void MarketGenerator::sweep(InstrumentState& inst, Levels& levels, Side resting_side, size_t quantity) {
+    const Side aggressor = opposite(resting_side);
+    size_t remaining = quantity;
+    std::uint32_t levels_swept = 0;
+
+    while (remaining > 0 && !levels.empty() && levels_swept < config_.max_sweep_levels) {
+        auto level_it = levels.begin();
+        const price_t price = level_it->first;
+        auto& level = level_it->second;
+
+        while (remaining > 0 && level.live > 0) {
+            const order_id_t order_id = level.queue.front();
+            auto order_it = inst.orders.find(order_id);
+            if (order_it == inst.orders.end()) {
+                level.queue.pop_front();  // Cancelled earlier
+                continue;
+            }
+
+            const size_t fill = std::min(remaining, order_it->second.size);
+            pending_.push_back(make_record(inst, Action::TRADE, aggressor, price, fill, order_id));
+            pending_.push_back(make_record(inst, Action::FILL, resting_side, price, fill, order_id));
+            pending_.push_back(make_record(inst, Action::CANCEL, resting_side, price, fill, order_id));
+            remaining -= fill;
+
+            if (fill < order_it->second.size) {
+                order_it->second.size -= fill;
+                continue;
+            }
+
+            // Fully filled: drop from the live set and the level queue
+            const std::size_t live_index = order_it->second.live_index;
+            inst.live[live_index] = inst.live.back();
+            inst.orders[inst.live[live_index]].live_index = live_index;
+            inst.live.pop_back();
+            inst.orders.erase(order_it);
+            level.queue.pop_front();
+            --level.live;
+            --resting_orders_;
+        }
+
+        if (level.live == 0) {
+            levels.erase(level_it);
+        }
+        ++levels_swept;
+    }
+}
+
+void MarketGenerator::insert_order(InstrumentState& inst, order_id_t order_id, Side side,
+                                   price_t price, size_t size) {
+    GeneratedLevel& level = (side == Side::BID) ? inst.bids[price] : inst.asks[price];
+    level.queue.push_back(order_id);
+    ++level.live;
+
+    inst.orders.emplace(order_id, GeneratedOrder{price, size, side, inst.live.size()});
+    inst.live.push_back(order_id);
+    ++resting_orders_;
+}
+
+void MarketGenerator::remove_order(InstrumentState& inst, order_id_t order_id) {
+    auto it = inst.orders.find(order_id);
+    if (it == inst.orders.end()) {
+        return;
+    }
+    const GeneratedOrder order = it->second;
+
+    // Swap-remove from the live set
+    inst.live[order.live_index] = inst.live.back();
+    inst.orders[inst.live[order.live_index]].live_index = order.live_index;
+    inst.live.pop_back();
+    inst.orders.erase(order_id);
+    --resting_orders_;
+
+    auto release = [&](auto& levels) {
+        auto level_it = levels.find(order.price);
+        if (level_it == levels.end()) {
+            return;
+        }
+        auto& level = level_it->second;
+        if (--level.live == 0) {
+            levels.erase(level_it);
+            return;
+        }
+        // Compact queues that are mostly cancelled ids
+        if (level.queue.size() > 2 * static_cast<std::size_t>(level.live) + 16) {
+            std::erase_if(level.queue, [&](order_id_t id) {
+                return inst.orders.find(id) == inst.orders.end();
+            });
+        }
+    };
+
+    if (order.side == Side::BID) {
+        release(inst.bids);
+    } else {
+        release(inst.asks);
+    }
+}
+
+MBORecord MarketGenerator::make_record(const InstrumentState& inst, Action action, Side side,
+                                       price_t price, size_t size, order_id_t order_id) {
+    MBORecord record;
+    record.timestamp.ts_recv = ts_recv_;
+    record.timestamp.ts_event = ts_event_;
+    record.rtype = RecordType::MBO;
+    record.publisher_id = config_.publisher_id;
+    record.instrument_id = inst.instrument_id;
+    record.action = action;
+    record.side = side;
+    record.price = price;
+    record.size = size;
+    record.channel_id = inst.channel_id;
+    record.order_id = order_id;
+    record.flags = 0;
+    record.ts_in_delta = static_cast<std::uint32_t>(100 + exponential(50.0));
+    record.sequence = ++channel_sequences_[inst.channel_id - 1];
+    record.symbol = inst.symbol;
+    return record;
+}
+
+void MarketGenerator::advance_clock() {
+    const double mean_gap_ns = 1e9 / std::max(config_.events_per_second, 1e-9);
+    ts_event_ += std::max<timestamp_t>(1, std::llround(exponential(mean_gap_ns)));
+
+    // Capture latency, kept monotonic like a real capture
+    const timestamp_t latency = 1000 + std::llround(exponential(500.0));
+    ts_recv_ = std::max(ts_recv_, ts_event_ + latency);
+}
+
+double MarketGenerator::uniform() {
+    return static_cast<double>(rng_() >> 11) * 0x1.0p-53;
+}
+
+double MarketGenerator::exponential(double mean) {
+    return -mean * std::log1p(-uniform());
+}
+
+double MarketGenerator::normal() {
+    // Box-Muller (one variate per call keeps the stream simple)
+    const double u1 = 1.0 - uniform();
+    const double u2 = uniform();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(kTwoPi * u2);
+}
+
+std::uint64_t MarketGenerator::geometric(double mean) {
+    if (mean <= 0.0) {
+        return 0;
+    }
+    // Failures before the first success, with the requested mean
+    const double p = 1.0 / (1.0 + mean);
+    return static_cast<std::uint64_t>(std::floor(std::log1p(-uniform()) / std::log1p(-p)));
+}
+
+std::size_t MarketGenerator::pick_instrument() {
+    if (instruments_.size() == 1) {
+        return 0;
+    }
+    const double u = uniform();
+    auto it = std::upper_bound(instrument_cdf_.begin(), instrument_cdf_.end(), u);
+    return std::min<std::size_t>(it - instrument_cdf_.begin(), instruments_.size() - 1);
+}
+
+} // namespace orderbook
@@ -0,0 +1,154 @@
+#include "mbo_merge.hpp"
+#include "orderbook.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace orderbook {
+
+// BlockLineReader implementation
+
+BlockLineReader::BlockLineReader(const std::string& path, std::size_t block_size)
+    : input_(path, std::ios::binary)
+    , buffer_(std::max<std::size_t>(block_size, 64)) {
+    if (!input_.is_open()) {
+        throw std::runtime_error("Cannot open input file: " + path);
+    }
+}
+
+void BlockLineReader::fill() {
+    // Keep the partial line, growing the block if it fills it
+    const std::size_t pending = end_ - begin_;
+    if (begin_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, pending);
+    } else if (pending == buffer_.size()) {
+        buffer_.resize(buffer_.size() * 2);
+    }
+    begin_ = 0;
+    end_ = pending;
+
+    input_.read(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+    end_ += static_cast<std::size_t>(input_.gcount());
+    eof_ = !input_;
+}
+
+bool BlockLineReader::next_line(std::string_view& line) {
+    for (;;) {
+        const char* start = buffer_.data() + begin_;
+        const auto* newline = static_cast<const char*>(std::memchr(start, '\n', end_ - begin_));
+        if (newline) {
+            line = std::string_view(start, static_cast<std::size_t>(newline - start));
+            begin_ += line.size() + 1;
+            return true;
+        }
+        if (eof_) {
+            // Last line without a trailing newline
+            if (begin_ == end_) {
+                return false;
+            }
+            line = std::string_view(start, end_ - begin_);
+            begin_ = end_;
+            return true;
+        }
+        fill();
+    }
+}
+
+// MboMerger implementation
+
+MboMerger::MboMerger(const std::vector<std::string>& input_files, std::size_t block_size) {
+    if (input_files.empty()) {
+        throw std::runtime_error("Merge needs at least one input file");
+    }
+    readers_.reserve(input_files.size());
+    for (const auto& file : input_files) {
+        readers_.emplace_back(file, block_size);
+    }
+    heads_.resize(readers_.size());
+    tree_.resize(readers_.size());
+    stats_.records.assign(readers_.size(), 0);
+    stats_.out_of_order.assign(readers_.size(), 0);
+}
+
+void MboMerger::advance(std::size_t input) {
+    std::optional<timestamp_t> previous_ts;
+    sequence_t previous_sequence = 0;
+    if (heads_[input]) {
+        previous_ts = heads_[input]->timestamp.ts_recv;
+        previous_sequence = heads_[input]->sequence;
+    }
+    heads_[input].reset();
+
+    // Skips headers and malformed lines
+    std::string_view line;
+    while (readers_[input].next_line(line)) {
+        line_.assign(line);
+        if (auto record = CSVParser::parse_mbo_line(line_)) {
+            if (previous_ts && (record->timestamp.ts_recv < *previous_ts ||
+                                (record->timestamp.ts_recv == *previous_ts && record->sequence < previous_sequence))) {
+                stats_.out_of_order[input]++;
+            }
+            heads_[input] = std::move(record);
+            return;
+        }
+    }
+}
+
+bool MboMerger::before(std::size_t lhs, std::size_t rhs) const noexcept {
+    // Exhausted inputs lose every match
+    if (!heads_[lhs] || !heads_[rhs]) {
+        return heads_[lhs] && !heads_[rhs];
+    }
+    const MBORecord& a = *heads_[lhs];
+    const MBORecord& b = *heads_[rhs];
+    if (a.timestamp.ts_recv != b.timestamp.ts_recv) {
+        return a.timestamp.ts_recv < b.timestamp.ts_recv;
+    }
+    if (a.sequence != b.sequence) {
+        return a.sequence < b.sequence;
+    }
+    return lhs < rhs;
+}
+
+// Initial tournament: leaves are nodes [M, 2M); returns the subtree's winner
+// and stores each match's loser at its node
+std::size_t MboMerger::play(std::size_t node) {
+    const std::size_t count = readers_.size();
+    if (node >= count) {
+        return node - count;
+    }
+    const std::size_t left = play(2 * node);
+    const std::size_t right = play(2 * node + 1);
+    const bool left_wins = before(left, right);
+    tree_[node] = left_wins ? right : left;
+    return left_wins ? left : right;
+}
+
+std::optional<MBORecord> MboMerger::next() {
+    if (!started_) {
+        for (std::size_t input = 0; input < readers_.size(); ++input) {
+            advance(input);
+        }
+        tree_[0] = play(1);
+        started_ = true;
+    } else {
+        // Refill the last winner and replay its path to the root
+        std::size_t winner = tree_[0];
+        advance(winner);
+        for (std::size_t node = (winner + readers_.size()) / 2; node > 0; node /= 2) {
+            if (before(tree_[node], winner)) {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
+    const std::size_t winner = tree_[0];
+    if (!heads_[winner]) {
+        return std::nullopt;
+    }
+    stats_.records[winner]++;
+    return *heads_[winner];
+}
+
+} // namespace orderbook
@@ -12,26 +12,44 @@ namespace orderbook {
 
 // Orderbook implementation
 Orderbook::Orderbook() 
-    : bid_side_(std::make_unique<OrderbookSide>())
-    , ask_side_(std::make_unique<OrderbookSide>()) {
+    : bid_side_(std::make_unique<OrderbookSide>(Side::BID))
+    , ask_side_(std::make_unique<OrderbookSide>(Side::ASK)) {
 }
 
 void Orderbook::process_mbo_record(const MBORecord& record) {
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    // Skip initial clear action
-    if (record.action == Action::CLEAR && record.sequence == 0) {
-        return;
+    // A staged snapshot ends at the first record that does not extend it
+    const bool snapshot_add = bulk_snapshots_ && record.action == Action::ADD && (record.flags & FLAG_SNAPSHOT);
+    if (!snapshot_add && record.action != Action::CLEAR) {
+        finish_snapshot();
     }
     
     // Handle different action types
     switch (record.action) {
+        case Action::CLEAR:
+            clear();
+            break;
         case Action::ADD:
-            handle_add_order(record);
+            if (!snapshot_add) {
+                handle_add_order(record);
+            } else {
+                if (record.side == Side::BID) {
+                    snapshot_bids_.push_back({record.order_id, record.price, record.size});
+                } else if (record.side == Side::ASK) {
+                    snapshot_asks_.push_back({record.order_id, record.price, record.size});
+                }
+                if (record.flags & FLAG_LAST) {
+                    finish_snapshot();
+                }
+            }
             break;
         case Action::CANCEL:
             handle_cancel_order(record);
             break;
+        case Action::MODIFY:
+            handle_modify_order(record);
+            break;
         case Action::TRADE:
         case Action::FILL:
             handle_trade_sequence(record);
@@ -76,6 +94,84 @@ MBPRecord Orderbook::generate_mbp_record(const MBORecord& record) const {
     return mbp_record;
 }
 
+std::array<PriceLevel, MAX_DEPTH> Orderbook::top_levels(Side side) const {
+    return (side == Side::ASK) ? ask_side_->get_top_levels() : bid_side_->get_top_levels();
+}
+
+std::optional<OrderView> Orderbook::find_order(order_id_t order_id) const {
+    if (auto order = bid_side_->find_order(order_id)) {
+        return OrderView{Side::BID, order->first, order->second};
+    }
+    if (auto order = ask_side_->find_order(order_id)) {
+        return OrderView{Side::ASK, order->first, order->second};
+    }
+    return std::nullopt;
+}
+
+std::size_t Orderbook::order_count() const noexcept {
+    return bid_side_->size() + ask_side_->size();
+}
+
+std::size_t Orderbook::level_count() const noexcept {
+    return bid_side_->level_count() + ask_side_->level_count();
+}
+
+std::vector<BookLevel> Orderbook::book_levels(Side side, std::size_t depth, bool with_orders) const {
+    const OrderbookSide& book_side = (side == Side::ASK) ? *ask_side_ : *bid_side_;
+    std::vector<BookLevel> result;
+    result.reserve(depth > 0 ? std::min(depth, book_side.levels_.size()) : book_side.levels_.size());
+    for (const auto& [price, level] : book_side.levels_) {
+        if (depth > 0 && result.size() >= depth) {
+            break;
+        }
+        BookLevel& out = result.emplace_back();
+        out.price = price;
+        out.size = level.total_size;
+        out.count = level.order_count;
+        if (with_orders) {
+            out.orders.assign(level.orders.begin(), level.orders.end());
+            std::sort(out.orders.begin(), out.orders.end());
+        }
+    }
+    return result;
+}
+
+void Orderbook::clear() noexcept {
+    bid_side_->clear();
+    ask_side_->clear();
+    pending_trades_.clear();
+    snapshot_bids_.clear();
+    snapshot_asks_.clear();
+    // The next delta starts from an empty book instead of listing every removal
+    cleared_since_delta_ = track_changes_;
+    changed_trades_.clear();
+}
+
+void Orderbook::set_bulk_snapshots(bool enabled) {
+    if (!enabled) {
+        finish_snapshot();
+    }
+    bulk_snapshots_ = enabled;
+}
+
+void Orderbook::finish_snapshot() {
+    if (!snapshot_bids_.empty()) {
+        bid_side_->bulk_add(snapshot_bids_);
+        snapshot_bids_.clear();
+    }
+    if (!snapshot_asks_.empty()) {
+        ask_side_->bulk_add(snapshot_asks_);
+        snapshot_asks_.clear();
+    }
+}
+
+void Orderbook::reserve(std::size_t expected_orders) {
+    // Sides are rarely balanced exactly; leave headroom on each
+    const std::size_t per_side = expected_orders / 2 + expected_orders / 8;
+    bid_side_->reserve(per_side);
+    ask_side_->reserve(per_side);
+}
+
 void Orderbook::handle_add_order(const MBORecord& record) {
     if (record.side == Side::BID) {
         bid_side_->add_order(record.order_id, record.price, record.size);
@@ -92,6 +188,20 @@ void Orderbook::handle_cancel_order(const MBORecord& record) {
     }
 }
 
+void Orderbook::handle_modify_order(const MBORecord& record) {
+    if (record.side != Side::BID && record.side != Side::ASK) {
+        return;
+    }
+    OrderbookSide& side = (record.side == Side::BID) ? *bid_side_ : *ask_side_;
+    OrderbookSide& opposite = (record.side == Side::BID) ? *ask_side_ : *bid_side_;
+    
+    // A side change is a cancel on the old side and an add on the new one
+    if (auto order = opposite.find_order(record.order_id)) {
+        opposite.cancel_order(record.order_id, order->first, order->second);
+    }
+    side.modify_order(record.order_id, record.price, record.size);
+}
+
 void Orderbook::handle_trade_sequence(const MBORecord& record) {
     // Handle special T->F->C sequence logic
     if (record.action == Action::TRADE) {
@@ -103,12 +213,18 @@ void Orderbook::handle_trade_sequence(const MBORecord& record) {
         seq.remaining_size = record.size;
         seq.timestamp = record.timestamp.ts_event;
         
+        if (track_changes_ && !changed_trades_.count(record.order_id)) {
+            changed_trades_.emplace(record.order_id, !pending_trades_.count(record.order_id));
+        }
         pending_trades_[record.order_id] = seq;
     } else if (record.action == Action::FILL) {
         // Update pending trade
         auto it = pending_trades_.find(record.order_id);
         if (it != pending_trades_.end()) {
             it->second.remaining_size -= record.size;
+            if (track_changes_) {
+                changed_trades_.try_emplace(record.order_id, false);
+            }
         }
     } else if (record.action == Action::CANCEL) {
         // Process the complete T->F->C sequence
@@ -126,6 +242,9 @@ void Orderbook::handle_trade_sequence(const MBORecord& record) {
             }
             
             pending_trades_.erase(it);
+            if (track_changes_) {
+                changed_trades_.try_emplace(record.order_id, false);
+            }
         }
     }
 }
@@ -179,6 +298,105 @@ void OrderbookSide::trade_order(order_id_t order_id, price_t /*price*/, size_t s
     }
 }
 
+void OrderbookSide::modify_order(order_id_t order_id, price_t price, size_t size) {
+    auto order = order_lookup_.find(order_id);
+    if (order == order_lookup_.end()) {
+        // Added before the stream started (or the add was lost)
+        if (size > 0) {
+            add_order(order_id, price, size);
+        }
+        return;
+    }
+    auto& [order_price, order_size] = order->second;
+    if (size == 0) {
+        cancel_order(order_id, order_price, order_size);
+        return;
+    }
+    
+    if (changes_) {
+        changes_->orders.try_emplace(order_id, false);
+        track_level_order(order_price, order_id);
+        if (price != order_price) {
+            track_level_order(price, order_id);
+        }
+    }
+    
+    auto level = levels_.find(order_price);
+    if (price == order_price && level != levels_.end()) {
+        // Same level: resize the entry, the level map is not touched
+        auto& same_level = level->second;
+        auto [entry, added] = same_level.orders.try_emplace(order_id, 0);
+        same_level.total_size -= std::min(entry->second, same_level.total_size);
+        same_level.total_size += size;
+        same_level.order_count += added;
+        entry->second = size;
+    } else {
+        // Unlink from the old level, then link into the new one
+        if (level != levels_.end()) {
+            auto& old_level = level->second;
+            auto entry = old_level.orders.find(order_id);
+            if (entry != old_level.orders.end()) {
+                old_level.total_size -= std::min(entry->second, old_level.total_size);
+                old_level.orders.erase(entry);
+                old_level.order_count = old_level.total_size == 0 ? 0 : old_level.order_count - 1;
+            }
+            if (old_level.total_size == 0) {
+                levels_.erase(level);
+            }
+        }
+        auto& new_level = levels_.try_emplace(price).first->second;
+        new_level.price = price;
+        new_level.total_size += size;
+        new_level.order_count++;
+        new_level.orders[order_id] = size;
+        order_price = price;
+    }
+    order_size = size;
+}
+
+void OrderbookSide::bulk_add(std::vector<SnapshotOrder>& orders) {
+    // Lookup first, in arrival order, so a repeated order id keeps its last add
+    order_lookup_.reserve(order_lookup_.size() + orders.size());
+    for (const auto& order : orders) {
+        if (changes_) {
+            changes_->orders.try_emplace(order.order_id, !order_lookup_.count(order.order_id));
+        }
+        order_lookup_[order.order_id] = {order.price, order.size};
+    }
+    
+    // Best first: on an empty side (the usual case, after a clear) every new
+    // level is appended at the end of the map
+    const auto better = levels_.key_comp();
+    std::stable_sort(orders.begin(), orders.end(), [&](const SnapshotOrder& lhs, const SnapshotOrder& rhs) {
+        return better(lhs.price, rhs.price);
+    });
+    for (auto begin = orders.begin(); begin != orders.end();) {
+        const price_t price = begin->price;
+        const auto end = std::find_if(begin, orders.end(), [price](const SnapshotOrder& order) {
+            return order.price != price;
+        });
+        if (changes_) {
+            for (auto it = begin; it != end; ++it) {
+                track_level_order(price, it->order_id);
+            }
+        }
+        
+        const auto level = levels_.try_emplace(levels_.end(), price);
+        auto& entry = level->second;
+        entry.price = price;
+        entry.orders.reserve(entry.orders.size() + static_cast<std::size_t>(end - begin));
+        for (auto it = begin; it != end; ++it) {
+            entry.total_size += it->size;
+            entry.order_count++;
+            entry.orders[it->order_id] = it->size;
+        }
+        if (entry.total_size == 0) {
+            levels_.erase(level);
+        }
+        begin = end;
+    }
+}
+
 std::array<PriceLevel, MAX_DEPTH> OrderbookSide::get_top_levels() const {
     std::array<PriceLevel, MAX_DEPTH> result;
     result.fill(PriceLevel{});
@@ -203,9 +421,23 @@ size_t OrderbookSide::get_order_size(order_id_t order_id) const {
     return (it != order_lookup_.end()) ? it->second.second : 0;
 }
 
+std::optional<std::pair<price_t, size_t>> OrderbookSide::find_order(order_id_t order_id) const {
+    auto it = order_lookup_.find(order_id);
+    if (it == order_lookup_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
 void OrderbookSide::clear() noexcept {
-    levels_.clear();
-    order_lookup_.clear();
+    reset_tables();
+    if (changes_) {
+        *changes_ = SideChanges{};
+    }
+}
+
+void OrderbookSide::reserve(std::size_t expected_orders) {
+    order_lookup_.reserve(expected_orders);
 }
 
 std::size_t OrderbookSide::size() const noexcept {
@@ -216,7 +448,30 @@ bool OrderbookSide::empty() const noexcept {
     return order_lookup_.empty();
 }
 
+void OrderbookSide::reset_tables() noexcept {
+    // Release the arena's chunks, then construct empty tables over the old
+    // ones without running their destructors: those would only hand the
+    // same memory back one node at a time.
+    const LevelOrder order = levels_.key_comp();
+    arena_->release();
+    new (&levels_) LevelMap(order, arena_.get());
+    new (&order_lookup_) OrderLookup(arena_.get());
+}
+
+void OrderbookSide::track_level_order(price_t price, order_id_t order_id) {
+    const auto level = levels_.find(price);
+    changes_->levels.try_emplace(price, level == levels_.end());
+    auto [entry, first] = changes_->level_orders.try_emplace({price, order_id}, true);
+    if (first && level != levels_.end()) {
+        entry->second = !level->second.orders.count(order_id);
+    }
+}
+
 void OrderbookSide::update_level(price_t price, order_id_t order_id, size_t size, bool is_add) {
+    if (changes_) {
+        track_level_order(price, order_id);
+    }
+    
     auto& level = levels_[price];
     level.price = price;
     
@@ -250,6 +505,10 @@ void OrderbookSide::remove_level_if_empty(price_t price) {
 }
 
 void OrderbookSide::update_order_lookup(order_id_t order_id, price_t price, size_t size, bool is_add) {
+    if (changes_ && !changes_->orders.count(order_id)) {
+        changes_->orders.emplace(order_id, !order_lookup_.count(order_id));
+    }
+    
     if (is_add) {
         order_lookup_[order_id] = std::make_pair(price, size);
     } else {
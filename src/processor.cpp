@@ -1,4 +1,9 @@
 #include "orderbook.hpp"
+#include "replay_index.hpp"
+#include "checkpoint_chain.hpp"
+#include "reorder_buffer.hpp"
+#include "feed_arbiter.hpp"
+#include "mbo_merge.hpp"
 #include <fstream>
 #include <iostream>
 #include <thread>
@@ -12,44 +17,136 @@
 #include <thread>
 #include <iomanip>
 #include <functional>
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <limits>
 
 namespace orderbook {
 
-// OrderbookProcessor implementation
+namespace {
 
-void OrderbookProcessor::process_file(const std::string& input_file, const std::string& output_file) {
+// How every segment of a parallel replay writes its rows
+struct SegmentOptions {
+    std::uint64_t emit_from = 0;  // First line start with a row (where a fast-forward ended)
+    bool event_batches = false;
+    bool bulk_snapshots = false;
+    // Line ends after which the state pass built a staged snapshot early
+    // for a periodic checkpoint, as process_file does
+    std::vector<std::uint64_t> snapshot_flushes;
+};
+
+// One segment of a parallel replay: book state from the checkpoint, rows
+// for the lines in [begin, end) written to part_file. Returns the rows
+// suppressed inside events.
+std::uint64_t replay_segment(const std::string& input_file, const std::string& part_file,
+                             const std::string& checkpoint, std::uint64_t begin, std::uint64_t end,
+                             const SegmentOptions& options) {
     std::ifstream input(input_file);
     if (!input.is_open()) {
         throw std::runtime_error("Cannot open input file: " + input_file);
     }
-    
-    std::ofstream output(output_file);
+    std::vector<char> buffer(1 << 20);
+    std::ofstream output;
+    output.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    output.open(part_file, std::ios::binary | std::ios::trunc);
     if (!output.is_open()) {
-        throw std::runtime_error("Cannot open output file: " + output_file);
+        throw std::runtime_error("Cannot open output file: " + part_file);
     }
     
-    // Write header
-    output << ",ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,depth,price,size,flags,ts_in_delta,sequence";
+    if (end <= options.emit_from) {
+        return 0;  // Entirely before the start: no rows
+    }
     
-    // Write bid level headers
-    for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
-        output << ",bid_px_" << std::setfill('0') << std::setw(2) << i
-               << ",bid_sz_" << std::setfill('0') << std::setw(2) << i
-               << ",bid_ct_" << std::setfill('0') << std::setw(2) << i;
+    Orderbook orderbook;
+    orderbook.load_checkpoint(checkpoint);
+    orderbook.set_bulk_snapshots(options.bulk_snapshots);
+    auto flush = std::upper_bound(options.snapshot_flushes.begin(), options.snapshot_flushes.end(), begin);
+    
+    input.seekg(static_cast<std::streamoff>(begin));
+    std::uint64_t offset = begin;
+    std::uint64_t suppressed = 0;
+    std::string line;
+    while (offset < end && std::getline(input, line)) {
+        const bool emitting = offset >= options.emit_from;
+        offset += line.size() + (input.eof() ? 0 : 1);
+        auto mbo_record = CSVParser::parse_mbo_line(line);
+        if (mbo_record) {
+            orderbook.process_mbo_record(*mbo_record);
+            if (emitting && options.event_batches && !(mbo_record->flags & FLAG_LAST)) {
+                suppressed++;
+            } else if (emitting) {
+                output << CSVParser::format_mbp_record(orderbook.generate_mbp_record(*mbo_record)) << "\n";
+            }
+        }
+        if (flush != options.snapshot_flushes.end() && *flush == offset) {
+            orderbook.finish_snapshot();
+            ++flush;
+        }
+    }
+    output.flush();
+    if (!output) {
+        throw std::runtime_error("Cannot write output file: " + part_file);
     }
+    return suppressed;
+}
+
+void print_sequence_summary(const SequenceTracker& tracker) {
+    const auto stats = tracker.stats();
+    std::cout << "  Sequence gaps: " << stats.gaps << " (" << stats.missing << " missing), duplicates: "
+              << stats.duplicates << " over " << stats.channels << " channels\n"
+              << "  Book valid: " << (tracker.book_valid() ? "yes" : "no") << "\n";
+}
+
+} // namespace
+
+// OrderbookProcessor implementation
+
+void OrderbookProcessor::process_file(const std::string& input_file, const std::string& output_file) {
+    std::ifstream input(input_file);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot open input file: " + input_file);
+    }
+    suppressed_rows_ = 0;
+    sequence_tracker_.reset();
     
-    // Write ask level headers
-    for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
-        output << ",ask_px_" << std::setfill('0') << std::setw(2) << i
-               << ",ask_sz_" << std::setfill('0') << std::setw(2) << i
-               << ",ask_ct_" << std::setfill('0') << std::setw(2) << i;
+    // Held records have no input position, so only the end-of-input
+    // checkpoint (taken after the window drains) is consistent
+    if (reorder_config_) {
+        if (checkpoint_every_ > 0 || !chain_prefix_.empty()) {
+            throw std::runtime_error("Reordering cannot be combined with periodic checkpoints");
+        }
+        reorder_ = std::make_unique<ReorderBuffer>(*reorder_config_);
+        reorder_stats_ = ReorderStats{};
     }
     
-    output << ",symbol,order_id\n";
+    std::ofstream output;
+    if (!state_only_) {
+        output.open(output_file);
+        if (!output.is_open()) {
+            throw std::runtime_error("Cannot open output file: " + output_file);
+        }
+        write_header(output);
+    }
+    emitting_ = !state_only_ && !start_ts_event_ && !start_sequence_;
     
-    // Skip header line in input
-    std::string header;
-    std::getline(input, header);
+    std::optional<CheckpointChain> chain;
+    if (!chain_prefix_.empty()) {
+        chain.emplace(chain_prefix_, chain_full_every_);
+    }
+    
+    // Skip header line in input, or continue where the checkpoint left off
+    std::uint64_t offset = 0;
+    if (resume_checkpoint_.empty() && resume_chain_.empty()) {
+        position_ = CheckpointPosition{};
+        std::string header;
+        if (std::getline(input, header)) {
+            offset = header.size() + (input.eof() ? 0 : 1);
+        }
+    } else {
+        resume_from_checkpoint(input, input_file, chain ? &*chain : nullptr);
+        offset = position_.byte_offset;
+    }
     
     // Process file in chunks for performance
     std::vector<std::string> lines;
@@ -57,10 +154,14 @@ void OrderbookProcessor::process_file(const std::string& input_file, const std::
     
     std::string line;
     std::size_t line_count = 0;
+    last_checkpoint_ = position_.records;
+    last_chain_point_ = position_.records;
+    BackgroundCheckpointer checkpointer;
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
     while (std::getline(input, line)) {
+        offset += line.size() + (input.eof() ? 0 : 1);
         lines.push_back(line);
         line_count++;
         
@@ -74,16 +175,26 @@ void OrderbookProcessor::process_file(const std::string& input_file, const std::
             processed_records_.clear();
             
             lines.clear();
+            position_.byte_offset = offset;
+            save_periodic_checkpoints(chain ? &*chain : nullptr, checkpointer);
         }
     }
     
-    // Process remaining lines
+    // Process remaining lines, then whatever the reorder window still holds
     if (!lines.empty()) {
         process_chunk(lines);
-        for (const auto& record : processed_records_) {
-            output << record << "\n";
-        }
     }
+    if (reorder_) {
+        reorder_->flush([this](const MBORecord& record) { handle_record(record); });
+        reorder_stats_ = reorder_->stats();
+        reorder_.reset();
+    }
+    for (const auto& record : processed_records_) {
+        output << record << "\n";
+    }
+    processed_records_.clear();
+    position_.byte_offset = offset;
+    save_final_checkpoints(chain ? &*chain : nullptr, checkpointer);
     
     auto end_time = std::chrono::high_resolution_clock::now();
     auto processing_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -91,7 +202,457 @@ void OrderbookProcessor::process_file(const std::string& input_file, const std::
     std::cout << "Processing completed:\n"
               << "  Lines processed: " << line_count << "\n"
               << "  Processing time: " << processing_time.count() << " ms\n"
-              << "  Records per second: " << (line_count * 1000 / processing_time.count()) << "\n";
+              << "  Records per second: " << (line_count * 1000 / std::max<std::int64_t>(processing_time.count(), 1)) << "\n";
+    if (event_batches_) {
+        std::cout << "  Rows suppressed inside events: " << suppressed_rows_ << "\n";
+    }
+    if (reorder_config_) {
+        std::cout << "  Reordered: " << reorder_stats_.late << " late, " << reorder_stats_.dropped
+                  << " dropped, at most " << reorder_stats_.max_held << " held\n";
+    }
+    print_sequence_summary(sequence_tracker_);
+}
+
+void OrderbookProcessor::save_periodic_checkpoints(CheckpointChain* chain, BackgroundCheckpointer& checkpointer) {
+    if (!checkpoint_path_.empty() && checkpoint_every_ > 0 &&
+        position_.records - last_checkpoint_ >= checkpoint_every_) {
+        orderbook_.finish_snapshot();
+        if (!background_checkpoints_) {
+            orderbook_.save_checkpoint(checkpoint_path_, position_);
+            last_checkpoint_ = position_.records;
+        } else if (checkpointer.start(orderbook_, checkpoint_path_, position_)) {
+            last_checkpoint_ = position_.records;
+        }
+    }
+    if (chain && chain_every_ > 0 && position_.records - last_chain_point_ >= chain_every_) {
+        orderbook_.finish_snapshot();
+        chain->save(orderbook_, position_);
+        last_chain_point_ = position_.records;
+    }
+}
+
+void OrderbookProcessor::save_final_checkpoints(CheckpointChain* chain, BackgroundCheckpointer& checkpointer) {
+    orderbook_.finish_snapshot();
+    checkpointer.wait();
+    background_stats_ = checkpointer.stats();
+    if (!checkpoint_path_.empty()) {
+        orderbook_.save_checkpoint(checkpoint_path_, position_);
+    }
+    if (chain) {
+        if (chain->points().empty() || chain->points().back().position.records != position_.records) {
+            chain->save(orderbook_, position_);
+        }
+        if (chain_keep_ > 0) {
+            chain->compact(chain_keep_);
+        }
+    }
+    
+    if (background_stats_.started > 0) {
+        std::cout << "Background checkpoints: " << background_stats_.completed << " written, "
+                  << background_stats_.skipped << " skipped, "
+                  << background_stats_.failed << " failed; parent pause max "
+                  << background_stats_.max_pause.count() / 1000 << " us, total "
+                  << background_stats_.total_pause.count() / 1000 << " us\n";
+    }
+}
+
+void OrderbookProcessor::resume_from_checkpoint(std::ifstream& input, const std::string& input_file,
+                                                CheckpointChain* chain) {
+    if (resume_chain_.empty()) {
+        position_ = orderbook_.load_checkpoint(resume_checkpoint_);
+    } else if (chain && chain->prefix() == resume_chain_) {
+        // Continuing the same chain: the next point can be a delta
+        position_ = chain->restore_latest(orderbook_);
+    } else {
+        position_ = CheckpointChain(resume_chain_).restore_latest(orderbook_);
+    }
+    
+    // The offset must be a line start inside this file
+    input.seekg(0, std::ios::end);
+    const auto file_size = static_cast<std::uint64_t>(input.tellg());
+    if (position_.byte_offset == 0 || position_.byte_offset > file_size) {
+        throw std::runtime_error("Checkpoint offset " + std::to_string(position_.byte_offset) +
+                                 " is outside input file: " + input_file);
+    }
+    char previous = 0;
+    input.seekg(static_cast<std::streamoff>(position_.byte_offset) - 1);
+    input.get(previous);
+    if (previous != '\n' && position_.byte_offset != file_size) {
+        throw std::runtime_error("Checkpoint offset " + std::to_string(position_.byte_offset) +
+                                 " is not at a line start in: " + input_file);
+    }
+    input.clear();
+    input.seekg(static_cast<std::streamoff>(position_.byte_offset));
+    
+    std::cout << "Resumed from checkpoint at byte " << position_.byte_offset
+              << " (record " << position_.records << ", sequence " << position_.sequence << ")\n";
+}
+
+void OrderbookProcessor::process_file_parallel(const std::string& input_file, const std::string& output_file,
+                                               std::size_t segments) {
+    if (reorder_config_) {
+        throw std::runtime_error("Reordering is only supported for sequential processing");
+    }
+    std::ifstream input(input_file);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot open input file: " + input_file);
+    }
+    suppressed_rows_ = 0;
+    sequence_tracker_.reset();
+    input.seekg(0, std::ios::end);
+    const auto file_size = static_cast<std::uint64_t>(input.tellg());
+    input.seekg(0);
+    
+    std::optional<CheckpointChain> chain;
+    if (!chain_prefix_.empty()) {
+        chain.emplace(chain_prefix_, chain_full_every_);
+    }
+    
+    std::uint64_t offset = 0;
+    if (resume_checkpoint_.empty() && resume_chain_.empty()) {
+        position_ = CheckpointPosition{};
+        std::string header;
+        if (std::getline(input, header)) {
+            offset = header.size() + (input.eof() ? 0 : 1);
+        }
+    } else {
+        resume_from_checkpoint(input, input_file, chain ? &*chain : nullptr);
+        offset = position_.byte_offset;
+    }
+    segments = std::max<std::size_t>(segments, 1);
+    
+    // Segment checkpoints and outputs live next to the output until concatenated
+    std::vector<std::string> part_files;
+    std::vector<std::string> checkpoints;
+    auto cleanup = [&]() {
+        for (const auto& file : part_files) {
+            std::filesystem::remove(file);
+        }
+        for (const auto& file : checkpoints) {
+            std::filesystem::remove(file);
+        }
+    };
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    // Phase 1: state-only pass, checkpointing at the first line start at or
+    // past each equal-size byte boundary. Periodic checkpoints and chain
+    // points are taken here, at the same chunk boundaries as process_file.
+    // A state-only run stops here. With a start, rows begin at the line
+    // where the sequential fast-forward would end.
+    const std::uint64_t data_begin = offset;
+    SegmentOptions options;
+    options.emit_from = (start_ts_event_ || start_sequence_) ? std::numeric_limits<std::uint64_t>::max() : 0;
+    options.event_batches = event_batches_;
+    options.bulk_snapshots = orderbook_.bulk_snapshots();
+    std::vector<std::uint64_t> starts;
+    auto checkpoint_here = [&]() {
+        const std::string part = output_file + ".part" + std::to_string(starts.size());
+        part_files.push_back(part);
+        checkpoints.push_back(part + ".ckpt");
+        position_.byte_offset = offset;
+        orderbook_.finish_snapshot();
+        orderbook_.save_checkpoint(checkpoints.back(), position_);
+        starts.push_back(offset);
+    };
+    if (!state_only_) {
+        checkpoint_here();
+    }
+    
+    std::string line;
+    std::size_t line_count = 0;
+    last_checkpoint_ = position_.records;
+    last_chain_point_ = position_.records;
+    BackgroundCheckpointer checkpointer;
+    while (std::getline(input, line)) {
+        // A boundary inside a staged snapshot moves to the line after it
+        if (!state_only_ && starts.size() < segments && !orderbook_.snapshot_pending() &&
+            offset >= data_begin + (file_size - data_begin) * starts.size() / segments) {
+            checkpoint_here();
+        }
+        const std::uint64_t line_start = offset;
+        offset += line.size() + (input.eof() ? 0 : 1);
+        line_count++;
+        
+        auto mbo_record = CSVParser::parse_mbo_line(line);
+        if (mbo_record) {
+            if (options.emit_from > line_start &&
+                ((start_ts_event_ && mbo_record->timestamp.ts_event >= *start_ts_event_) ||
+                 (start_sequence_ && mbo_record->sequence >= *start_sequence_))) {
+                options.emit_from = line_start;
+            }
+            apply_record(*mbo_record);
+            position_.records++;
+            position_.sequence = mbo_record->sequence;
+            position_.ts_event = mbo_record->timestamp.ts_event;
+        }
+        if (line_count % buffer_size_ == 0) {
+            const bool pending = orderbook_.snapshot_pending();
+            position_.byte_offset = offset;
+            save_periodic_checkpoints(chain ? &*chain : nullptr, checkpointer);
+            if (pending && !orderbook_.snapshot_pending()) {
+                options.snapshot_flushes.push_back(offset);
+            }
+        }
+    }
+    position_.byte_offset = offset;
+    starts.push_back(offset);
+    
+    auto state_time = std::chrono::high_resolution_clock::now();
+    
+    // Phase 2: workers write each segment's rows from its checkpoint
+    const std::size_t parts = part_files.size();
+    const std::size_t worker_count = std::clamp<std::size_t>(thread_count_, 1, std::max<std::size_t>(parts, 1));
+    if (!state_only_) {
+        std::vector<std::exception_ptr> errors(parts);
+        std::vector<std::uint64_t> suppressed(parts, 0);
+        std::atomic<std::size_t> next_part{0};
+        auto worker = [&]() {
+            for (std::size_t i = next_part++; i < parts; i = next_part++) {
+                try {
+                    suppressed[i] = replay_segment(input_file, part_files[i], checkpoints[i], starts[i], starts[i + 1],
+                                                   options);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < worker_count; ++i) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        
+        for (const auto& error : errors) {
+            if (error) {
+                cleanup();
+                std::rethrow_exception(error);
+            }
+        }
+        for (std::uint64_t count : suppressed) {
+            suppressed_rows_ += count;
+        }
+        
+        // Concatenate the parts after the header
+        std::ofstream output(output_file, std::ios::binary | std::ios::trunc);
+        if (!output.is_open()) {
+            cleanup();
+            throw std::runtime_error("Cannot open output file: " + output_file);
+        }
+        write_header(output);
+        for (const auto& part : part_files) {
+            std::ifstream part_input(part, std::ios::binary);
+            if (part_input.peek() != std::ifstream::traits_type::eof()) {
+                output << part_input.rdbuf();
+            }
+        }
+        output.close();
+        cleanup();
+    }
+    
+    save_final_checkpoints(chain ? &*chain : nullptr, checkpointer);
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto state_ms = std::chrono::duration_cast<std::chrono::milliseconds>(state_time - start_time);
+    auto output_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - state_time);
+    auto total_ms = std::max<std::int64_t>((state_ms + output_ms).count(), 1);
+    
+    std::cout << "Parallel processing completed:\n"
+              << "  Lines processed: " << line_count << "\n"
+              << "  Segments: " << parts << " on " << worker_count << " threads\n"
+              << "  State pass: " << state_ms.count() << " ms\n"
+              << "  Output pass: " << output_ms.count() << " ms\n"
+              << "  Records per second: " << (line_count * 1000 / total_ms) << "\n";
+    if (event_batches_) {
+        std::cout << "  Rows suppressed inside events: " << suppressed_rows_ << "\n";
+    }
+    print_sequence_summary(sequence_tracker_);
+}
+
+void OrderbookProcessor::process_feeds(const std::string& line_a, const std::string& line_b,
+                                       const std::string& output_file, std::size_t window) {
+    FeedArbiter arbiter(line_a, line_b, window);
+    process_records([&arbiter]() { return arbiter.next(); }, output_file);
+    arbiter_stats_ = arbiter.stats();
+    
+    std::cout << "  Line A: " << arbiter_stats_.read[0] << " read, " << arbiter_stats_.delivered[0] << " delivered\n"
+              << "  Line B: " << arbiter_stats_.read[1] << " read, " << arbiter_stats_.delivered[1] << " delivered\n"
+              << "  Duplicates dropped: " << arbiter_stats_.duplicates << "\n"
+              << "  Held behind gaps: " << arbiter_stats_.held << "\n"
+              << "  Sequences missing on both lines: " << arbiter_stats_.gaps << "\n";
+}
+
+void OrderbookProcessor::process_merged(const std::vector<std::string>& input_files,
+                                        const std::string& output_file) {
+    MboMerger merger(input_files);
+    process_records([&merger]() { return merger.next(); }, output_file);
+    merge_stats_ = merger.stats();
+    
+    for (std::size_t i = 0; i < input_files.size(); ++i) {
+        std::cout << "  " << input_files[i] << ": " << merge_stats_.records[i] << " records";
+        if (merge_stats_.out_of_order[i] > 0) {
+            std::cout << ", " << merge_stats_.out_of_order[i] << " out of order";
+        }
+        std::cout << "\n";
+    }
+}
+
+void OrderbookProcessor::process_records(const std::function<std::optional<MBORecord>()>& next,
+                                         const std::string& output_file) {
+    // Without a single input file there is no byte offset to checkpoint
+    if (!checkpoint_path_.empty() || !chain_prefix_.empty() || !resume_checkpoint_.empty() ||
+        !resume_chain_.empty() || reorder_config_) {
+        throw std::runtime_error("Checkpoints and reordering need a single input file");
+    }
+    suppressed_rows_ = 0;
+    sequence_tracker_.reset();
+    position_ = CheckpointPosition{};
+    
+    std::ofstream output;
+    if (!state_only_) {
+        output.open(output_file);
+        if (!output.is_open()) {
+            throw std::runtime_error("Cannot open output file: " + output_file);
+        }
+        write_header(output);
+    }
+    emitting_ = !state_only_ && !start_ts_event_ && !start_sequence_;
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::size_t record_count = 0;
+    auto write_rows = [&]() {
+        for (const auto& row : processed_records_) {
+            output << row << "\n";
+        }
+        processed_records_.clear();
+    };
+    while (auto record = next()) {
+        handle_record(*record);
+        record_count++;
+        if (processed_records_.size() >= buffer_size_) {
+            write_rows();
+        }
+    }
+    orderbook_.finish_snapshot();
+    write_rows();
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto processing_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    std::cout << "Processing completed:\n"
+              << "  Records processed: " << record_count << "\n"
+              << "  Processing time: " << processing_time.count() << " ms\n"
+              << "  Records per second: " << (record_count * 1000 / std::max<std::int64_t>(processing_time.count(), 1)) << "\n";
+    if (event_batches_) {
+        std::cout << "  Rows suppressed inside events: " << suppressed_rows_ << "\n";
+    }
+    print_sequence_summary(sequence_tracker_);
+}
+
+void OrderbookProcessor::process_window(const std::string& input_file, const std::string& output_file,
+                                        const ReplayIndex& index, timestamp_t t0, timestamp_t t1) {
+    if (reorder_config_) {
+        throw std::runtime_error("Reordering is only supported for sequential processing");
+    }
+    std::ifstream input(input_file);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot open input file: " + input_file);
+    }
+    suppressed_rows_ = 0;
+    sequence_tracker_.reset();
+    input.seekg(0, std::ios::end);
+    if (static_cast<std::uint64_t>(input.tellg()) != index.input_size()) {
+        throw std::runtime_error("Index was built for a different version of: " + input_file);
+    }
+    
+    std::ofstream output(output_file);
+    if (!output.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + output_file);
+    }
+    write_header(output);
+    
+    // Nearest checkpoint at or before t0, otherwise an empty book at the first record
+    std::uint64_t offset = index.data_offset();
+    if (auto entry = index.seek_checkpoint(t0)) {
+        position_ = orderbook_.load_checkpoint(index.checkpoint_path(*entry));
+        offset = entry->byte_offset;
+    } else {
+        orderbook_.clear();
+        position_ = CheckpointPosition{};
+    }
+    input.clear();
+    input.seekg(static_cast<std::streamoff>(offset));
+    
+    std::string line;
+    std::size_t skipped = 0;
+    std::size_t written = 0;
+    bool started = false;
+    while (std::getline(input, line)) {
+        offset += line.size() + (input.eof() ? 0 : 1);
+        auto mbo_record = CSVParser::parse_mbo_line(line);
+        if (!mbo_record) {
+            continue;
+        }
+        
+        const timestamp_t ts_event = mbo_record->timestamp.ts_event;
+        started = started || ts_event >= t0;
+        if (started && ts_event > t1) {
+            break;
+        }
+        
+        apply_record(*mbo_record);
+        position_.records++;
+        position_.sequence = mbo_record->sequence;
+        position_.ts_event = ts_event;
+        position_.byte_offset = offset;
+        
+        if (started && event_batches_ && !(mbo_record->flags & FLAG_LAST)) {
+            suppressed_rows_++;
+        } else if (started) {
+            output << CSVParser::format_mbp_record(orderbook_.generate_mbp_record(*mbo_record)) << "\n";
+            written++;
+        } else {
+            skipped++;
+        }
+    }
+    
+    std::cout << "Window completed:\n"
+              << "  Replayed before window: " << skipped << "\n"
+              << "  Rows written: " << written << "\n";
+    if (event_batches_) {
+        std::cout << "  Rows suppressed inside events: " << suppressed_rows_ << "\n";
+    }
+    print_sequence_summary(sequence_tracker_);
+}
+
+void OrderbookProcessor::write_header(std::ofstream& output) const {
+    output << ",ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,depth,price,size,flags,ts_in_delta,sequence";
+    
+    // Write bid level headers
+    for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
+        output << ",bid_px_" << std::setfill('0') << std::setw(2) << i
+               << ",bid_sz_" << std::setfill('0') << std::setw(2) << i
+               << ",bid_ct_" << std::setfill('0') << std::setw(2) << i;
+    }
+    
+    // Write ask level headers
+    for (std::size_t i = 0; i < MAX_DEPTH; ++i) {
+        output << ",ask_px_" << std::setfill('0') << std::setw(2) << i
+               << ",ask_sz_" << std::setfill('0') << std::setw(2) << i
+               << ",ask_ct_" << std::setfill('0') << std::setw(2) << i;
+    }
+    
+    output << ",symbol,order_id\n";
+}
+
+void OrderbookProcessor::apply_record(const MBORecord& record) {
+    sequence_tracker_.check(record);
+    orderbook_.process_mbo_record(record);
+    if (record.action == Action::CLEAR) {
+        // The book is rebuilt from here (a snapshot follows the clear)
+        sequence_tracker_.revalidate();
+    }
 }
 
 void OrderbookProcessor::process_chunk(const std::vector<std::string>& lines) {
@@ -102,16 +663,39 @@ void OrderbookProcessor::process_chunk(const std::vector<std::string>& lines) {
             continue;  // Skip invalid lines
         }
         
-        // Process the record
-        orderbook_.process_mbo_record(*mbo_record);
-        
+        if (reorder_) {
+            reorder_->push(std::move(*mbo_record), [this](const MBORecord& record) { handle_record(record); });
+        } else {
+            handle_record(*mbo_record);
+        }
+    }
+}
+
+void OrderbookProcessor::handle_record(const MBORecord& record) {
+    // Fast-forward ends at the first record at or past the start
+    if (!emitting_ && !state_only_) {
+        emitting_ = (start_ts_event_ && record.timestamp.ts_event >= *start_ts_event_) ||
+                    (start_sequence_ && record.sequence >= *start_sequence_);
+    }
+    
+    // Process the record
+    apply_record(record);
+    
+    if (emitting_ && event_batches_ && !(record.flags & FLAG_LAST)) {
+        // Inside an event: the book is not consistent until its last record
+        suppressed_rows_++;
+    } else if (emitting_) {
         // Generate MBP record
-        auto mbp_record = orderbook_.generate_mbp_record(*mbo_record);
+        auto mbp_record = orderbook_.generate_mbp_record(record);
         
         // Format for output
         std::string formatted_record = CSVParser::format_mbp_record(mbp_record);
         processed_records_.push_back(formatted_record);
     }
+    
+    position_.records++;
+    position_.sequence = record.sequence;
+    position_.ts_event = record.timestamp.ts_event;
 }
 
 void OrderbookProcessor::write_mbp_record(const MBPRecord& record, std::ofstream& output) {
@@ -0,0 +1,57 @@
+#include "reorder_buffer.hpp"
+#include <stdexcept>
+
+namespace orderbook {
+
+ReorderBuffer::ReorderBuffer(const ReorderConfig& config)
+    : config_(config) {
+    if (config_.max_records == 0 && config_.max_distance == 0) {
+        throw std::runtime_error("Reorder window needs a record count or a distance bound");
+    }
+    heap_.reserve(config_.max_records + 1);
+}
+
+std::uint64_t ReorderBuffer::key_of(const MBORecord& record) const noexcept {
+    return config_.key == ReorderKey::SEQUENCE ? record.sequence
+                                               : static_cast<std::uint64_t>(record.timestamp.ts_recv);
+}
+
+bool ReorderBuffer::admit(MBORecord record) {
+    // An unsequenced record (e.g. a clear) keeps its arrival position: keyed
+    // at the newest sequence so far, it leaves after everything that arrived
+    // before it and is never late
+    const bool unsequenced = config_.key == ReorderKey::SEQUENCE && record.sequence == 0;
+    const std::uint64_t key = unsequenced ? newest_key_ : key_of(record);
+    const std::uint64_t arrival = stats_.records++;
+    if (arrival > 0 && key < newest_key_) {
+        stats_.late++;
+        if (released_any_ && key < released_key_) {
+            stats_.dropped++;
+            return false;
+        }
+    }
+    newest_key_ = arrival == 0 ? key : std::max(newest_key_, key);
+
+    heap_.push_back(Entry{key, arrival, std::move(record)});
+    std::push_heap(heap_.begin(), heap_.end(), Later{});
+    stats_.max_held = std::max(stats_.max_held, heap_.size());
+    return true;
+}
+
+bool ReorderBuffer::must_release() const noexcept {
+    if (config_.max_records > 0 && heap_.size() > config_.max_records) {
+        return true;
+    }
+    return config_.max_distance > 0 && newest_key_ - heap_.front().key > config_.max_distance;
+}
+
+MBORecord ReorderBuffer::pop() {
+    std::pop_heap(heap_.begin(), heap_.end(), Later{});
+    Entry entry = std::move(heap_.back());
+    heap_.pop_back();
+    released_key_ = entry.key;
+    released_any_ = true;
+    return std::move(entry.record);
+}
+
+} // namespace orderbook
@@ -0,0 +1,212 @@
+#include "replay_index.hpp"
+#include "orderbook.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace orderbook {
+
+// Index file layout (host byte order, version 1):
+//
+//   u32 magic "OBIX", u32 version
+//   u64 input_size, u64 data_offset
+//   u64 every_records, i64 every_ms, u64 checkpoint_every
+//   u32 checkpoint_dir length, checkpoint_dir bytes
+//   u64 entries, per entry: i64 ts_event, u64 sequence, u64 byte_offset,
+//                           u64 records, u8 has_checkpoint
+
+namespace {
+
+constexpr std::uint32_t INDEX_MAGIC = 0x5849424F;  // "OBIX"
+constexpr std::uint32_t INDEX_VERSION = 1;
+constexpr timestamp_t NANOS_PER_MS = 1000000;
+
+template<typename T>
+void put(std::ostream& output, T value) {
+    output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+T get(std::istream& input) {
+    T value;
+    if (!input.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Invalid index: truncated file");
+    }
+    return value;
+}
+
+} // namespace
+
+ReplayIndex ReplayIndex::build(const std::string& input_file, const std::string& index_file,
+                               const IndexConfig& config) {
+    std::ifstream input(input_file);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot open input file: " + input_file);
+    }
+
+    ReplayIndex index;
+    index.config_ = config;
+    if (index.config_.checkpoint_dir.empty()) {
+        index.config_.checkpoint_dir = index_file + ".ckpt";
+    }
+    if (index.config_.checkpoint_every > 0) {
+        std::filesystem::create_directories(index.config_.checkpoint_dir);
+    }
+
+    std::string line;
+    std::getline(input, line);  // Header
+    std::uint64_t offset = line.size() + (input.eof() ? 0 : 1);
+    index.data_offset_ = offset;
+
+    Orderbook book;
+    const bool replay = index.config_.checkpoint_every > 0;
+    const timestamp_t every_ns = config.every_ms * NANOS_PER_MS;
+    CheckpointPosition position;
+    IndexEntry running;
+    timestamp_t last_entry_ts = 0;
+    std::uint64_t last_entry_records = 0;
+
+    while (std::getline(input, line)) {
+        const std::uint64_t line_offset = offset;
+        offset += line.size() + (input.eof() ? 0 : 1);
+
+        auto record = CSVParser::parse_mbo_line(line);
+        if (!record) {
+            continue;
+        }
+        running.ts_event = std::max(running.ts_event, record->timestamp.ts_event);
+        running.sequence = std::max(running.sequence, record->sequence);
+
+        const bool due = index.entries_.empty() ||
+                         position.records - last_entry_records >= config.every_records ||
+                         (every_ns > 0 && running.ts_event - last_entry_ts >= every_ns);
+        if (due) {
+            IndexEntry entry = running;
+            entry.byte_offset = line_offset;
+            entry.records = position.records;
+            // Entry 0 is the empty book; no checkpoint needed
+            entry.has_checkpoint = replay && !index.entries_.empty() &&
+                                   index.entries_.size() % index.config_.checkpoint_every == 0;
+            if (entry.has_checkpoint) {
+                position.byte_offset = line_offset;
+                book.save_checkpoint(index.checkpoint_path(entry), position);
+            }
+            index.entries_.push_back(entry);
+            last_entry_ts = running.ts_event;
+            last_entry_records = position.records;
+        }
+
+        if (replay) {
+            book.process_mbo_record(*record);
+        }
+        position.records++;
+        position.sequence = record->sequence;
+        position.ts_event = record->timestamp.ts_event;
+    }
+
+    index.input_size_ = offset;
+    index.save(index_file);
+    return index;
+}
+
+void ReplayIndex::save(const std::string& index_file) const {
+    std::ofstream output(index_file, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        throw std::runtime_error("Cannot open index file: " + index_file);
+    }
+    put(output, INDEX_MAGIC);
+    put(output, INDEX_VERSION);
+    put(output, input_size_);
+    put(output, data_offset_);
+    put(output, static_cast<std::uint64_t>(config_.every_records));
+    put(output, config_.every_ms);
+    put(output, static_cast<std::uint64_t>(config_.checkpoint_every));
+    put(output, static_cast<std::uint32_t>(config_.checkpoint_dir.size()));
+    output.write(config_.checkpoint_dir.data(), static_cast<std::streamsize>(config_.checkpoint_dir.size()));
+    put(output, static_cast<std::uint64_t>(entries_.size()));
+    for (const auto& entry : entries_) {
+        put(output, entry.ts_event);
+        put(output, entry.sequence);
+        put(output, entry.byte_offset);
+        put(output, entry.records);
+        put(output, static_cast<std::uint8_t>(entry.has_checkpoint));
+    }
+    if (!output) {
+        throw std::runtime_error("Cannot write index file: " + index_file);
+    }
+}
+
+ReplayIndex ReplayIndex::load(const std::string& index_file) {
+    std::ifstream input(index_file, std::ios::binary);
+    if (!input.is_open()) {
+        throw std::runtime_error("Cannot open index file: " + index_file);
+    }
+    if (get<std::uint32_t>(input) != INDEX_MAGIC) {
+        throw std::runtime_error("Invalid index: bad magic");
+    }
+    if (get<std::uint32_t>(input) != INDEX_VERSION) {
+        throw std::runtime_error("Invalid index: unsupported version");
+    }
+
+    ReplayIndex index;
+    index.input_size_ = get<std::uint64_t>(input);
+    index.data_offset_ = get<std::uint64_t>(input);
+    index.config_.every_records = get<std::uint64_t>(input);
+    index.config_.every_ms = get<std::int64_t>(input);
+    index.config_.checkpoint_every = get<std::uint64_t>(input);
+    index.config_.checkpoint_dir.resize(get<std::uint32_t>(input));
+    if (!input.read(index.config_.checkpoint_dir.data(),
+                    static_cast<std::streamsize>(index.config_.checkpoint_dir.size()))) {
+        throw std::runtime_error("Invalid index: truncated file");
+    }
+
+    const auto count = get<std::uint64_t>(input);
+    for (std::uint64_t i = 0; i < count; ++i) {
+        IndexEntry entry;
+        entry.ts_event = get<timestamp_t>(input);
+        entry.sequence = get<sequence_t>(input);
+        entry.byte_offset = get<std::uint64_t>(input);
+        entry.records = get<std::uint64_t>(input);
+        entry.has_checkpoint = get<std::uint8_t>(input) != 0;
+        index.entries_.push_back(entry);
+    }
+    return index;
+}
+
+std::optional<IndexEntry> ReplayIndex::seek_time(timestamp_t ts) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), ts,
+                               [](const IndexEntry& entry, timestamp_t value) { return entry.ts_event < value; });
+    if (it == entries_.begin()) {
+        return std::nullopt;
+    }
+    return *std::prev(it);
+}
+
+std::optional<IndexEntry> ReplayIndex::seek_sequence(sequence_t sequence) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), sequence,
+                               [](const IndexEntry& entry, sequence_t value) { return entry.sequence < value; });
+    if (it == entries_.begin()) {
+        return std::nullopt;
+    }
+    return *std::prev(it);
+}
+
+std::optional<IndexEntry> ReplayIndex::seek_checkpoint(timestamp_t ts) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), ts,
+                               [](const IndexEntry& entry, timestamp_t value) { return entry.ts_event < value; });
+    // Walk back to the nearest checkpointed entry (at most checkpoint_every steps)
+    while (it != entries_.begin()) {
+        --it;
+        if (it->has_checkpoint) {
+            return *it;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string ReplayIndex::checkpoint_path(const IndexEntry& entry) const {
+    return (std::filesystem::path(config_.checkpoint_dir) / (std::to_string(entry.records) + ".ckpt")).string();
+}
+
+} // namespace orderbook
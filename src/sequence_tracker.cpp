@@ -0,0 +1,61 @@
+#include "sequence_tracker.hpp"
+
+namespace orderbook {
+
+SequenceStatus SequenceTracker::check_slow(publisher_id_t publisher_id, std::uint16_t channel_id,
+                                           sequence_t sequence) {
+    if (sequence == 0) {
+        return SequenceStatus::UNSEQUENCED;
+    }
+    if (publisher_id >= last_.size()) {
+        last_.resize(static_cast<std::size_t>(publisher_id) + 1);
+    }
+    auto& channels = last_[publisher_id];
+    if (channel_id >= channels.size()) {
+        channels.resize(static_cast<std::size_t>(channel_id) + 1, 0);
+    }
+
+    sequence_t& last = channels[channel_id];
+    if (last == 0 || sequence - last <= 1) {
+        // First record on the channel (or a key that only just got a slot)
+        last = sequence;
+        return SequenceStatus::IN_SEQUENCE;
+    }
+
+    const SequenceGap event{publisher_id, channel_id, last + 1, sequence};
+    SequenceStatus status;
+    if (sequence > last) {
+        stats_.gaps++;
+        stats_.missing += sequence - last - 1;
+        last = sequence;
+        status = SequenceStatus::GAP;
+    } else {
+        // Keep waiting for last + 1: a stale record does not move the channel back
+        stats_.duplicates++;
+        status = SequenceStatus::DUPLICATE;
+    }
+    valid_ = false;
+    if (handler_) {
+        handler_(event);
+    }
+    return status;
+}
+
+void SequenceTracker::reset() {
+    last_.clear();
+    stats_ = SequenceStats{};
+    valid_ = true;
+}
+
+SequenceStats SequenceTracker::stats() const {
+    SequenceStats stats = stats_;
+    stats.channels = 0;
+    for (const auto& channels : last_) {
+        for (sequence_t last : channels) {
+            stats.channels += last != 0;
+        }
+    }
+    return stats;
+}
+
+} // namespace orderbook
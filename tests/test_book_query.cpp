@@ -0,0 +1,141 @@
+#include "book_query.hpp"
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace orderbook {
+namespace test {
+
+namespace fs = std::filesystem;
+
+class BookQueryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / ("book_query_test_" + std::to_string(::getpid()));
+        fs::create_directories(dir_);
+
+        MarketGenerator generator;
+        records_ = generator.generate(20000);
+        std::ofstream output(path("mbo.csv"));
+        output << MarketGenerator::csv_header() << "\n";
+        for (const auto& record : records_) {
+            output << MarketGenerator::format_mbo_line(record) << "\n";
+        }
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    ReplayIndex build_index() const {
+        IndexConfig config;
+        config.every_records = 1000;
+        config.every_ms = 0;
+        config.checkpoint_every = 2;
+        return ReplayIndex::build(path("mbo.csv"), path("mbo.csv.idx"), config);
+    }
+
+    // Full replay up to the first record past ts
+    void expect_book_at(const BookSnapshot& actual, timestamp_t ts) const {
+        Orderbook expected;
+        std::uint64_t applied = 0;
+        for (const auto& record : records_) {
+            if (record.timestamp.ts_event > ts) {
+                break;
+            }
+            expected.process_mbo_record(record);
+            applied++;
+        }
+        EXPECT_EQ(actual.position.records, applied);
+
+        const auto bids = expected.book_levels(Side::BID, 0, true);
+        const auto asks = expected.book_levels(Side::ASK, 0, true);
+        ASSERT_EQ(actual.bids.size(), bids.size());
+        ASSERT_EQ(actual.asks.size(), asks.size());
+        for (std::size_t i = 0; i < bids.size(); ++i) {
+            EXPECT_EQ(actual.bids[i].price, bids[i].price);
+            EXPECT_EQ(actual.bids[i].size, bids[i].size);
+            EXPECT_EQ(actual.bids[i].orders, bids[i].orders);
+        }
+        for (std::size_t i = 0; i < asks.size(); ++i) {
+            EXPECT_EQ(actual.asks[i].price, asks[i].price);
+            EXPECT_EQ(actual.asks[i].size, asks[i].size);
+            EXPECT_EQ(actual.asks[i].orders, asks[i].orders);
+        }
+    }
+
+    std::vector<MBORecord> records_;
+    fs::path dir_;
+};
+
+TEST_F(BookQueryTest, MatchesFullReplayAtAnyTime) {
+    BookQuery query(path("mbo.csv"), build_index(), 2);
+
+    // Out of order, so states are reused, loaded from checkpoints and evicted
+    for (std::size_t i : {15321u, 250u, 15400u, 7777u, 19999u, 0u, 12000u}) {
+        const timestamp_t ts = records_[i].timestamp.ts_event;
+        expect_book_at(query.book_at(ts, 0, true), ts);
+    }
+    EXPECT_GT(query.stats().checkpoint_loads, 0u);
+
+    const auto top = query.book_at(records_[5000].timestamp.ts_event, 3);
+    EXPECT_LE(top.bids.size(), 3u);
+    EXPECT_TRUE(top.bids.front().orders.empty());
+}
+
+TEST_F(BookQueryTest, CachedStateAdvancesInsteadOfReloading) {
+    BookQuery query(path("mbo.csv"), build_index());
+    query.book_at(records_[10100].timestamp.ts_event);
+    const auto loads = query.stats().checkpoint_loads;
+
+    // Slightly later: replays only the gap from the cached state
+    const auto replayed = query.stats().records_replayed;
+    query.book_at(records_[10600].timestamp.ts_event);
+    EXPECT_EQ(query.stats().checkpoint_loads, loads);
+    EXPECT_EQ(query.stats().cache_hits, 1u);
+    EXPECT_LE(query.stats().records_replayed - replayed, 510u);
+
+    // Same instant again: no replay at all
+    const auto again = query.stats().records_replayed;
+    query.book_at(records_[10600].timestamp.ts_event);
+    EXPECT_EQ(query.stats().records_replayed, again);
+}
+
+TEST_F(BookQueryTest, OneShotUsesDefaultIndex) {
+    build_index();
+    const timestamp_t ts = records_[9000].timestamp.ts_event;
+    expect_book_at(book_at(path("mbo.csv"), ts, 0, true), ts);
+
+    std::ofstream(path("mbo.csv"), std::ios::app) << "\n";
+    EXPECT_THROW(BookQuery(path("mbo.csv")), std::runtime_error);
+}
+
+TEST_F(BookQueryTest, OneShotReopensRewrittenFile) {
+    build_index();
+    const timestamp_t ts = records_[9000].timestamp.ts_event;
+    expect_book_at(book_at(path("mbo.csv"), ts, 0, true), ts);
+
+    // Same path, different content and index
+    MarketGeneratorConfig config;
+    config.seed = 7;
+    MarketGenerator generator(config);
+    records_ = generator.generate(15000);
+    {
+        std::ofstream output(path("mbo.csv"), std::ios::trunc);
+        output << MarketGenerator::csv_header() << "\n";
+        for (const auto& record : records_) {
+            output << MarketGenerator::format_mbo_line(record) << "\n";
+        }
+    }
+    EXPECT_THROW(book_at(path("mbo.csv"), ts), std::runtime_error);  // Index is stale
+    build_index();
+    expect_book_at(book_at(path("mbo.csv"), ts, 0, true), ts);
+}
+
+} // namespace test
+} // namespace orderbook
@@ -0,0 +1,187 @@
+#include "checkpoint_chain.hpp"
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <sstream>
+#include <unistd.h>
+
+namespace orderbook {
+namespace test {
+
+namespace fs = std::filesystem;
+
+class CheckpointChainTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / ("checkpoint_chain_test_" + std::to_string(::getpid()));
+        fs::create_directories(dir_);
+
+        // Deep book, so an interval touches a small share of it
+        MarketGeneratorConfig config;
+        config.target_resting_orders = 5000;
+        config.initial_depth = 5000;
+        MarketGenerator generator(config);
+        records_ = generator.generate(30000);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    // Applies records [applied, end) and returns the matching position
+    CheckpointPosition advance(Orderbook& book, std::size_t end) {
+        for (; applied_ < end; ++applied_) {
+            book.process_mbo_record(records_[applied_]);
+        }
+        CheckpointPosition position;
+        position.byte_offset = applied_ * 100;
+        position.records = applied_;
+        position.sequence = records_[applied_ - 1].sequence;
+        position.ts_event = records_[applied_ - 1].timestamp.ts_event;
+        return position;
+    }
+
+    void expect_same_book(const Orderbook& actual, const Orderbook& expected) const {
+        EXPECT_EQ(actual.order_count(), expected.order_count());
+        EXPECT_EQ(actual.level_count(), expected.level_count());
+        EXPECT_EQ(actual.top_levels(Side::BID), expected.top_levels(Side::BID));
+        EXPECT_EQ(actual.top_levels(Side::ASK), expected.top_levels(Side::ASK));
+        for (const auto& record : records_) {
+            const auto lhs = actual.find_order(record.order_id);
+            const auto rhs = expected.find_order(record.order_id);
+            ASSERT_EQ(lhs.has_value(), rhs.has_value()) << "order " << record.order_id;
+            if (lhs) {
+                ASSERT_EQ(lhs->price, rhs->price) << "order " << record.order_id;
+                ASSERT_EQ(lhs->size, rhs->size) << "order " << record.order_id;
+            }
+        }
+    }
+
+    std::vector<MBORecord> records_;
+    std::size_t applied_ = 0;
+    fs::path dir_;
+};
+
+TEST_F(CheckpointChainTest, DeltaReproducesBook) {
+    Orderbook book;
+    const auto base_position = advance(book, 10000);
+    std::stringstream base;
+    book.save_checkpoint(base, base_position);
+    book.set_change_tracking(true);
+
+    const auto position = advance(book, 10500);
+    std::stringstream delta;
+    book.save_delta(delta, base_position, position);
+    EXPECT_LT(delta.str().size(), base.str().size());
+
+    Orderbook restored;
+    restored.load_checkpoint(base);
+    const auto applied = restored.apply_delta(delta, base_position);
+    EXPECT_EQ(applied.records, position.records);
+    expect_same_book(restored, book);
+
+    // Continuing both books gives identical snapshots (pending trades included)
+    for (std::size_t i = applied_; i < records_.size(); ++i) {
+        book.process_mbo_record(records_[i]);
+        restored.process_mbo_record(records_[i]);
+        ASSERT_EQ(restored.generate_mbp_record(records_[i]).bid_levels,
+                  book.generate_mbp_record(records_[i]).bid_levels) << "record " << i;
+    }
+}
+
+TEST_F(CheckpointChainTest, DeltaRejectsWrongParentAndCorruption) {
+    Orderbook book;
+    const auto base_position = advance(book, 5000);
+    book.set_change_tracking(true);
+    const auto position = advance(book, 6000);
+    std::stringstream delta;
+    book.save_delta(delta, base_position, position);
+    const std::string bytes = delta.str();
+
+    Orderbook other;
+    const auto orders = other.order_count();
+    std::istringstream wrong_parent(bytes);
+    EXPECT_THROW(other.apply_delta(wrong_parent, CheckpointPosition{}), std::runtime_error);
+
+    std::string corrupt = bytes;
+    corrupt[bytes.size() / 2] ^= 0x40;
+    std::istringstream corrupt_input(corrupt);
+    EXPECT_THROW(other.apply_delta(corrupt_input, base_position), std::runtime_error);
+    EXPECT_EQ(other.order_count(), orders);
+}
+
+TEST_F(CheckpointChainTest, DeltaCarriesClear) {
+    Orderbook book;
+    const auto base_position = advance(book, 5000);
+    std::stringstream base;
+    book.save_checkpoint(base, base_position);
+    book.set_change_tracking(true);
+
+    book.clear();
+    const auto position = advance(book, 5500);
+    std::stringstream delta;
+    book.save_delta(delta, base_position, position);
+
+    Orderbook restored;
+    restored.load_checkpoint(base);
+    restored.apply_delta(delta, base_position);
+    expect_same_book(restored, book);
+}
+
+TEST_F(CheckpointChainTest, RestoresEveryPointAndReopens) {
+    Orderbook book;
+    CheckpointChain chain(path("book"), 3);
+    std::vector<std::size_t> orders;
+    std::vector<std::array<PriceLevel, MAX_DEPTH>> bids;
+    for (std::size_t end = 5000; end <= 30000; end += 5000) {
+        chain.save(book, advance(book, end));
+        orders.push_back(book.order_count());
+        bids.push_back(book.top_levels(Side::BID));
+    }
+
+    // Full, delta, delta, full, delta, delta
+    ASSERT_EQ(chain.points().size(), 6u);
+    for (std::size_t i = 0; i < chain.points().size(); ++i) {
+        EXPECT_EQ(chain.points()[i].full, i % 3 == 0) << "point " << i;
+    }
+
+    CheckpointChain reopened(path("book"), 3);
+    ASSERT_EQ(reopened.points().size(), 6u);
+    for (std::size_t i = 0; i < reopened.points().size(); ++i) {
+        Orderbook restored;
+        const auto position = reopened.restore(restored, i);
+        EXPECT_EQ(position.records, (i + 1) * 5000);
+        EXPECT_EQ(restored.order_count(), orders[i]);
+        EXPECT_EQ(restored.top_levels(Side::BID), bids[i]);
+    }
+    Orderbook latest;
+    reopened.restore_latest(latest);
+    expect_same_book(latest, book);
+}
+
+TEST_F(CheckpointChainTest, CompactFoldsOlderPoints) {
+    Orderbook book;
+    CheckpointChain chain(path("book"), 8);
+    for (std::size_t end = 3000; end < 30000; end += 3000) {
+        chain.save(book, advance(book, end));
+    }
+    const auto before = chain.disk_bytes();
+
+    chain.compact(3);
+    ASSERT_EQ(chain.points().size(), 3u);
+    EXPECT_TRUE(chain.points().front().full);
+    EXPECT_EQ(chain.points().front().position.records, 21000u);
+    EXPECT_LT(chain.disk_bytes(), before);
+
+    // The tracked book keeps extending the compacted chain with deltas
+    EXPECT_FALSE(chain.save(book, advance(book, records_.size())).full);
+    Orderbook restored;
+    CheckpointChain(path("book"), 8).restore_latest(restored);
+    expect_same_book(restored, book);
+}
+
+} // namespace test
+} // namespace orderbook
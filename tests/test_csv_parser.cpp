@@ -0,0 +1,42 @@
+#include "orderbook.hpp"
+#include <gtest/gtest.h>
+
+namespace orderbook {
+namespace test {
+
+TEST(CSVParserTest, TimeArgumentPrecisions) {
+    const timestamp_t second = 1752735910LL * 1000000000;  // 2025-07-17T07:05:10Z
+    EXPECT_EQ(CSVParser::parse_time_argument("2025-07-17T07:05:10Z"), second);
+    EXPECT_EQ(CSVParser::parse_time_argument("2025-07-17T07:05:10"), second);
+    EXPECT_EQ(CSVParser::parse_time_argument("2025-07-17T07:05:10.5Z"), second + 500000000);
+    EXPECT_EQ(CSVParser::parse_time_argument("2025-07-17T07:05:10.123Z"), second + 123000000);
+    EXPECT_EQ(CSVParser::parse_time_argument("2025-07-17T07:05:10.123456Z"), second + 123456000);
+    EXPECT_EQ(CSVParser::parse_time_argument("2025-07-17T07:05:10.123456789Z"), second + 123456789);
+    EXPECT_EQ(CSVParser::parse_time_argument(std::to_string(second + 42)), second + 42);
+
+    // Same value the CSV reader gives full-precision timestamps
+    EXPECT_EQ(CSVParser::parse_time_argument("2025-07-17T07:05:09.035793433Z"),
+              CSVParser::parse_timestamp("2025-07-17T07:05:09.035793433Z"));
+}
+
+TEST(CSVParserTest, TimeArgumentRejectsMalformed) {
+    for (const char* malformed : {
+             "",
+             "2025-07-17",
+             "2025-07-17 07:05:10Z",             // Space instead of 'T'
+             "2025-07-17T07:05:1xZ",             // Non-digit in a field
+             "20x5-07-17T07:05:10.000000000Z",   // Long enough for the CSV reader
+             "2025-13-17T07:05:10Z",             // Month out of range
+             "2025-02-30T07:05:10Z",             // Day past the end of the month
+             "2025-07-17T24:00:00Z",
+             "2025-07-17T07:05:10.Z",            // Empty fraction
+             "2025-07-17T07:05:10.1234567890Z",  // More than nanoseconds
+             "2025-07-17T07:05:10Zjunk",
+             "99999999999999999999",             // Overflows nanoseconds since epoch
+         }) {
+        EXPECT_FALSE(CSVParser::parse_time_argument(malformed).has_value()) << malformed;
+    }
+}
+
+} // namespace test
+} // namespace orderbook
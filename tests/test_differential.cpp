@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "differential.hpp"
+#include "market_generator.hpp"
+#include "orderbook.hpp"
+
+namespace orderbook {
+namespace test {
+
+namespace {
+
+DifferentialConfig small_config() {
+    DifferentialConfig config;
+    config.seed = 3;
+    config.lines = 2000;
+    config.streams = 10;
+    config.stream_length = 500;
+    return config;
+}
+
+// Engine that forgets to apply cancels
+class NoCancelEngine final : public BookEngine {
+public:
+    void apply(const MBORecord& record) override {
+        if (record.action != Action::CANCEL) {
+            book_.apply(record);
+        }
+    }
+    std::array<PriceLevel, MAX_DEPTH> top_levels(Side side) const override { return book_.top_levels(side); }
+    std::optional<OrderView> find_order(order_id_t order_id) const override { return book_.find_order(order_id); }
+    std::size_t order_count() const noexcept override { return book_.order_count(); }
+
+private:
+    Orderbook book_;
+};
+
+} // namespace
+
+TEST(DifferentialTest, ReferenceMatchesItself) {
+    const auto& parser = registered_line_parsers().front();
+    const auto& engine = registered_book_engines().front();
+
+    const auto report = run_differential(small_config(), parser, {parser}, engine, {engine});
+    EXPECT_TRUE(report.passed());
+    EXPECT_EQ(report.parser_cases, 4000u);
+    EXPECT_EQ(report.engine_streams, 10u);
+}
+
+TEST(DifferentialTest, DetectsAndMinimizesParserMismatch) {
+    const auto& reference = registered_line_parsers().front();
+    // Drops the sequence number
+    LineParserInfo broken{"broken", "", [](const std::string& line) {
+        auto record = CSVParser::parse_mbo_line(line);
+        if (record) {
+            record->sequence = 0;
+        }
+        return record;
+    }};
+
+    const auto& engine = registered_book_engines().front();
+    const auto report = run_differential(small_config(), reference, {broken}, engine, {});
+    ASSERT_EQ(report.failures.size(), 1u);
+    EXPECT_EQ(report.failures[0].kind, "parser");
+    EXPECT_NE(report.failures[0].detail.find("sequence"), std::string::npos);
+    EXPECT_LT(report.failures[0].minimized_size, report.failures[0].original_size);
+    EXPECT_TRUE(diff_parse(reference, broken, report.failures[0].input).has_value());
+}
+
+TEST(DifferentialTest, DetectsAndMinimizesEngineMismatch) {
+    const auto& parser = registered_line_parsers().front();
+    const auto& reference = registered_book_engines().front();
+    BookEngineInfo broken{"no-cancel", "", [] { return std::unique_ptr<BookEngine>(std::make_unique<NoCancelEngine>()); }};
+
+    const auto report = run_differential(small_config(), parser, {}, reference, {broken});
+    ASSERT_EQ(report.failures.size(), 1u);
+    EXPECT_EQ(report.failures[0].kind, "engine");
+    // An add followed by its cancel is the minimal failing stream
+    EXPECT_EQ(report.failures[0].minimized_size, 2u);
+}
+
+TEST(DifferentialTest, MinimizeFindsSmallestFailingSubset) {
+    std::vector<int> input(100);
+    for (int i = 0; i < 100; ++i) {
+        input[i] = i;
+    }
+    // Fails whenever both 17 and 83 are present
+    const auto minimized = minimize<int>(input, [](const std::vector<int>& subset) {
+        return std::find(subset.begin(), subset.end(), 17) != subset.end() &&
+               std::find(subset.begin(), subset.end(), 83) != subset.end();
+    });
+    EXPECT_EQ(minimized, (std::vector<int>{17, 83}));
+}
+
+TEST(DifferentialTest, FuzzerIsDeterministic) {
+    MarketGenerator generator;
+    const std::string line = MarketGenerator::format_mbo_line(generator.next());
+
+    MboFuzzer first(11);
+    MboFuzzer second(11);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(first.mutate_line(line), second.mutate_line(line));
+    }
+}
+
+} // namespace test
+} // namespace orderbook
@@ -0,0 +1,174 @@
+#include "feed_arbiter.hpp"
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include <gtest/gtest.h>
+#include <map>
+#include <sstream>
+
+namespace orderbook {
+namespace test {
+
+namespace {
+
+MBORecord record_on(std::uint16_t channel_id, sequence_t sequence, publisher_id_t publisher_id = 1) {
+    MBORecord record{};
+    record.publisher_id = publisher_id;
+    record.channel_id = channel_id;
+    record.sequence = sequence;
+    return record;
+}
+
+} // namespace
+
+TEST(FeedArbiterTest, SequenceWindowSlides) {
+    SequenceWindow window(100);
+    EXPECT_EQ(window.capacity(), 128u);
+    EXPECT_TRUE(window.mark(1000));
+    EXPECT_FALSE(window.mark(1000));
+    EXPECT_TRUE(window.mark(990));           // Older, still inside the window
+    EXPECT_TRUE(window.mark(1200));          // Slides: 1000 and 990 fall out
+    EXPECT_TRUE(window.contains(1000));      // Slid out counts as delivered
+    EXPECT_FALSE(window.mark(1000));
+    EXPECT_FALSE(window.contains(1199));
+    EXPECT_TRUE(window.mark(1199));
+    EXPECT_TRUE(window.mark(1200 + 128 * 5));  // Far ahead: clears everything
+    EXPECT_FALSE(window.contains(1300 + 128 * 4));
+}
+
+TEST(FeedArbiterTest, FirstArrivalWinsWholeMessage) {
+    FeedArbiter arbiter;
+    // Sequence 7 is a two-record message; A delivers it, B's copy is dropped
+    EXPECT_TRUE(arbiter.accept(0, record_on(1, 7)));
+    EXPECT_FALSE(arbiter.accept(1, record_on(1, 7)));
+    EXPECT_TRUE(arbiter.accept(0, record_on(1, 7)));
+    EXPECT_FALSE(arbiter.accept(1, record_on(1, 7)));
+
+    // B is first for 8, A for 9; other channels are independent
+    EXPECT_TRUE(arbiter.accept(1, record_on(1, 8)));
+    EXPECT_FALSE(arbiter.accept(0, record_on(1, 8)));
+    EXPECT_TRUE(arbiter.accept(0, record_on(1, 9)));
+    EXPECT_TRUE(arbiter.accept(1, record_on(2, 8)));
+
+    // Another publisher's channel 1 is a different channel
+    EXPECT_TRUE(arbiter.accept(0, record_on(1, 7, 2)));
+    EXPECT_FALSE(arbiter.accept(1, record_on(1, 7, 2)));
+
+    EXPECT_EQ(arbiter.stats().delivered[0], 4u);
+    EXPECT_EQ(arbiter.stats().delivered[1], 2u);
+    EXPECT_EQ(arbiter.stats().duplicates, 4u);
+}
+
+TEST(FeedArbiterTest, UnsequencedMatchedByContent) {
+    FeedArbiter arbiter;
+    MBORecord clear = record_on(1, 0);
+    clear.action = Action::CLEAR;
+    clear.timestamp.ts_event = 1000;
+    MBORecord later_clear = clear;
+    later_clear.timestamp.ts_event = 2000;
+
+    // Both lines carry it: applied once, from the first line to read it
+    EXPECT_TRUE(arbiter.accept(1, clear));
+    EXPECT_FALSE(arbiter.accept(0, clear));
+
+    // Line A lost the next one: taken from B
+    EXPECT_TRUE(arbiter.accept(1, later_clear));
+
+    // Two identical records on a line are two records; B supplies the
+    // second copy A lost
+    MBORecord add = record_on(1, 0);
+    add.action = Action::ADD;
+    add.order_id = 5;
+    EXPECT_TRUE(arbiter.accept(0, add));
+    EXPECT_FALSE(arbiter.accept(1, add));
+    EXPECT_TRUE(arbiter.accept(1, add));
+
+    EXPECT_EQ(arbiter.stats().delivered[0], 1u);
+    EXPECT_EQ(arbiter.stats().delivered[1], 3u);
+    EXPECT_EQ(arbiter.stats().duplicates, 2u);
+}
+
+TEST(FeedArbiterTest, LinesFillEachOthersGaps) {
+    MarketGenerator generator;
+    const auto records = generator.generate(10000);
+
+    // Each line loses a different tenth of the records
+    std::stringstream line_a;
+    std::stringstream line_b;
+    line_a << MarketGenerator::csv_header() << "\n";
+    line_b << MarketGenerator::csv_header() << "\n";
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        if (i % 10 != 3) {
+            line_a << MarketGenerator::format_mbo_line(records[i]) << "\n";
+        }
+        if (i % 10 != 8) {
+            line_b << MarketGenerator::format_mbo_line(records[i]) << "\n";
+        }
+    }
+
+    FeedArbiter arbiter(line_a, line_b);
+    Orderbook expected;
+    Orderbook actual;
+    std::size_t delivered = 0;
+    while (auto record = arbiter.next()) {
+        ASSERT_LT(delivered, records.size());
+        EXPECT_EQ(record->sequence, records[delivered].sequence);
+        EXPECT_EQ(record->order_id, records[delivered].order_id);
+        expected.process_mbo_record(records[delivered]);
+        actual.process_mbo_record(*record);
+        delivered++;
+    }
+    EXPECT_EQ(delivered, records.size());
+    EXPECT_EQ(actual.order_count(), expected.order_count());
+    EXPECT_EQ(arbiter.stats().delivered[1], records.size() / 10);
+    EXPECT_EQ(arbiter.stats().duplicates, records.size() * 8 / 10);
+}
+
+TEST(FeedArbiterTest, HoldsRecordsBehindAGapForTheLaggingLine) {
+    MarketGeneratorConfig config;
+    config.instrument_count = 2;
+    config.channel_count = 2;
+    MarketGenerator generator(config);
+    const auto records = generator.generate(10000);
+    const std::size_t lost_on_both = 5000;
+
+    // A loses a tenth of the records; B has the rest but receives everything
+    // 1 ms (about 50 records) later, so its fills arrive after A's next ones
+    std::stringstream line_a;
+    std::stringstream line_b;
+    line_a << MarketGenerator::csv_header() << "\n";
+    line_b << MarketGenerator::csv_header() << "\n";
+    std::map<std::uint16_t, std::vector<MBORecord>> expected;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        if (i == lost_on_both) {
+            continue;
+        }
+        expected[records[i].channel_id].push_back(records[i]);
+        if (i % 10 != 3) {
+            line_a << MarketGenerator::format_mbo_line(records[i]) << "\n";
+        }
+        MBORecord late = records[i];
+        late.timestamp.ts_recv += 1000000;
+        line_b << MarketGenerator::format_mbo_line(late) << "\n";
+    }
+
+    // Each channel comes out in sequence order, every record once
+    FeedArbiter arbiter(line_a, line_b);
+    std::map<std::uint16_t, std::vector<MBORecord>> actual;
+    while (auto record = arbiter.next()) {
+        actual[record->channel_id].push_back(*record);
+    }
+    ASSERT_EQ(actual.size(), expected.size());
+    for (const auto& [channel, channel_records] : expected) {
+        const auto& delivered = actual[channel];
+        ASSERT_EQ(delivered.size(), channel_records.size()) << "channel " << channel;
+        for (std::size_t i = 0; i < delivered.size(); ++i) {
+            EXPECT_EQ(delivered[i].sequence, channel_records[i].sequence);
+            EXPECT_EQ(delivered[i].order_id, channel_records[i].order_id);
+        }
+    }
+    EXPECT_GE(arbiter.stats().held, records.size() / 10);
+    EXPECT_EQ(arbiter.stats().gaps, 1u);  // Given up once both lines read past it
+}
+
+} // namespace test
+} // namespace orderbook
@@ -0,0 +1,163 @@
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <unordered_set>
+#include <map>
+
+namespace orderbook {
+namespace test {
+
+TEST(MarketGeneratorTest, SameSeedSameStream) {
+    MarketGenerator first;
+    MarketGenerator second;
+
+    for (std::size_t i = 0; i < 5000; ++i) {
+        EXPECT_EQ(MarketGenerator::format_mbo_line(first.next()),
+                  MarketGenerator::format_mbo_line(second.next()));
+    }
+
+    MarketGeneratorConfig config;
+    config.seed = 7;
+    MarketGenerator other(config);
+    MarketGenerator reference;
+    bool differs = false;
+    for (std::size_t i = 0; i < 100 && !differs; ++i) {
+        differs = MarketGenerator::format_mbo_line(other.next()) !=
+                  MarketGenerator::format_mbo_line(reference.next());
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(MarketGeneratorTest, CsvRoundTripsThroughParser) {
+    MarketGenerator generator;
+
+    for (std::size_t i = 0; i < 5000; ++i) {
+        const auto record = generator.next();
+        const auto parsed = CSVParser::parse_mbo_line(MarketGenerator::format_mbo_line(record));
+
+        ASSERT_TRUE(parsed.has_value());
+        EXPECT_EQ(parsed->timestamp.ts_recv, record.timestamp.ts_recv);
+        EXPECT_EQ(parsed->timestamp.ts_event, record.timestamp.ts_event);
+        EXPECT_EQ(parsed->rtype, record.rtype);
+        EXPECT_EQ(parsed->publisher_id, record.publisher_id);
+        EXPECT_EQ(parsed->instrument_id, record.instrument_id);
+        EXPECT_EQ(parsed->action, record.action);
+        EXPECT_EQ(parsed->side, record.side);
+        EXPECT_EQ(parsed->price, record.price);
+        EXPECT_EQ(parsed->size, record.size);
+        EXPECT_EQ(parsed->channel_id, record.channel_id);
+        EXPECT_EQ(parsed->order_id, record.order_id);
+        EXPECT_EQ(parsed->flags, record.flags);
+        EXPECT_EQ(parsed->ts_in_delta, record.ts_in_delta);
+        EXPECT_EQ(parsed->sequence, record.sequence);
+        EXPECT_EQ(parsed->symbol, record.symbol);
+    }
+}
+
+TEST(MarketGeneratorTest, TradesHitRestingOrders) {
+    MarketGenerator generator;
+    const auto records = generator.generate(50000);
+
+    std::map<order_id_t, std::pair<Side, size_t>> resting;
+    std::size_t adds = 0;
+    std::size_t cancels = 0;
+    std::size_t trades = 0;
+
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        const auto& record = records[i];
+        switch (record.action) {
+            case Action::ADD:
+                ++adds;
+                EXPECT_TRUE(resting.emplace(record.order_id, std::make_pair(record.side, record.size)).second);
+                break;
+            case Action::TRADE: {
+                ++trades;
+                ASSERT_LT(i + 2, records.size());
+                const auto& fill = records[i + 1];
+                const auto& cancel = records[i + 2];
+
+                // T on the aggressor side, then F and C on the resting order
+                auto it = resting.find(record.order_id);
+                ASSERT_NE(it, resting.end());
+                EXPECT_NE(record.side, it->second.first);
+                EXPECT_EQ(fill.action, Action::FILL);
+                EXPECT_EQ(cancel.action, Action::CANCEL);
+                EXPECT_EQ(fill.order_id, record.order_id);
+                EXPECT_EQ(cancel.order_id, record.order_id);
+                EXPECT_EQ(cancel.side, it->second.first);
+                EXPECT_LE(record.size, it->second.second);
+                break;
+            }
+            case Action::CANCEL: {
+                auto it = resting.find(record.order_id);
+                ASSERT_NE(it, resting.end());
+                if (i == 0 || records[i - 1].action != Action::FILL) {
+                    ++cancels;
+                }
+                it->second.second -= record.size;
+                if (it->second.second == 0) {
+                    resting.erase(it);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    EXPECT_GT(trades, 0u);
+    EXPECT_EQ(resting.size(), generator.resting_orders());
+
+    // Realistic cancel-to-add ratio
+    const double ratio = static_cast<double>(cancels) / static_cast<double>(adds);
+    EXPECT_GT(ratio, 0.8);
+    EXPECT_LT(ratio, 1.0);
+}
+
+TEST(MarketGeneratorTest, MultiInstrumentSequencesPerChannel) {
+    MarketGeneratorConfig config;
+    config.instrument_count = 8;
+    config.channel_count = 3;
+    MarketGenerator generator(config);
+
+    std::unordered_set<instrument_id_t> instruments;
+    std::map<std::uint16_t, sequence_t> last_sequence;
+    timestamp_t last_recv = 0;
+
+    for (const auto& record : generator.generate(20000)) {
+        instruments.insert(record.instrument_id);
+
+        auto& last = last_sequence[record.channel_id];
+        EXPECT_EQ(record.sequence, last + 1);
+        last = record.sequence;
+
+        EXPECT_GE(record.timestamp.ts_recv, last_recv);
+        EXPECT_GE(record.timestamp.ts_recv, record.timestamp.ts_event);
+        last_recv = record.timestamp.ts_recv;
+    }
+
+    EXPECT_EQ(instruments.size(), 8u);
+    EXPECT_EQ(last_sequence.size(), 3u);
+}
+
+TEST(MarketGeneratorTest, WritesParsableCsvFile) {
+    MarketGenerator generator;
+    std::ostringstream output;
+    generator.write_csv(output, 100);
+
+    std::istringstream input(output.str());
+    std::string line;
+    std::getline(input, line);
+    EXPECT_EQ(line, MarketGenerator::csv_header());
+
+    std::size_t parsed = 0;
+    while (std::getline(input, line)) {
+        EXPECT_TRUE(CSVParser::parse_mbo_line(line).has_value());
+        ++parsed;
+    }
+    EXPECT_EQ(parsed, 100u);
+}
+
+} // namespace test
+} // namespace orderbook
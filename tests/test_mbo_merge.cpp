@@ -0,0 +1,122 @@
+#include "mbo_merge.hpp"
+#include "market_generator.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace orderbook {
+namespace test {
+
+namespace fs = std::filesystem;
+
+class MboMergeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / ("mbo_merge_test_" + std::to_string(::getpid()));
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    std::string write_file(const std::string& name, const std::vector<MBORecord>& records) const {
+        const std::string file = (dir_ / name).string();
+        std::ofstream output(file);
+        output << MarketGenerator::csv_header() << "\n";
+        for (const auto& record : records) {
+            output << MarketGenerator::format_mbo_line(record) << "\n";
+        }
+        return file;
+    }
+
+    fs::path dir_;
+};
+
+TEST_F(MboMergeTest, BlockReaderSplitsLinesAcrossBlocks) {
+    const std::string file = (dir_ / "lines.txt").string();
+    const std::string long_line(300, 'x');
+    {
+        std::ofstream output(file);
+        output << "first\n\n" << long_line << "\nlast";  // No trailing newline
+    }
+
+    BlockLineReader reader(file, 16);
+    std::string_view line;
+    std::vector<std::string> lines;
+    while (reader.next_line(line)) {
+        lines.emplace_back(line);
+    }
+    EXPECT_EQ(lines, (std::vector<std::string>{"first", "", long_line, "last"}));
+    EXPECT_THROW(BlockLineReader((dir_ / "missing.csv").string()), std::runtime_error);
+}
+
+TEST_F(MboMergeTest, MergesChannelsInReceiveOrder) {
+    MarketGeneratorConfig config;
+    config.instrument_count = 5;
+    config.channel_count = 5;
+    MarketGenerator generator(config);
+    const auto records = generator.generate(20000);
+
+    // One file per channel plus an empty one
+    std::vector<std::vector<MBORecord>> per_channel(config.channel_count + 1);
+    for (const auto& record : records) {
+        per_channel[record.channel_id % config.channel_count].push_back(record);
+    }
+    std::vector<std::string> files;
+    for (std::size_t i = 0; i < per_channel.size(); ++i) {
+        files.push_back(write_file("channel" + std::to_string(i) + ".csv", per_channel[i]));
+    }
+
+    // Ties across files go to the earlier file, within one keep file order
+    std::vector<MBORecord> expected;
+    for (const auto& channel : per_channel) {
+        expected.insert(expected.end(), channel.begin(), channel.end());
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const MBORecord& a, const MBORecord& b) {
+        if (a.timestamp.ts_recv != b.timestamp.ts_recv) {
+            return a.timestamp.ts_recv < b.timestamp.ts_recv;
+        }
+        return a.sequence < b.sequence;
+    });
+
+    // Small blocks force many refills
+    MboMerger merger(files, 256);
+    std::size_t delivered = 0;
+    while (auto record = merger.next()) {
+        ASSERT_LT(delivered, expected.size());
+        EXPECT_EQ(record->timestamp.ts_recv, expected[delivered].timestamp.ts_recv);
+        EXPECT_EQ(record->sequence, expected[delivered].sequence);
+        EXPECT_EQ(record->order_id, expected[delivered].order_id);
+        delivered++;
+    }
+    EXPECT_EQ(delivered, records.size());
+    EXPECT_FALSE(merger.next());
+    for (std::size_t i = 0; i < per_channel.size(); ++i) {
+        EXPECT_EQ(merger.stats().records[i], per_channel[i].size());
+        EXPECT_EQ(merger.stats().out_of_order[i], 0u);
+    }
+}
+
+TEST_F(MboMergeTest, CountsOutOfOrderInput) {
+    MarketGenerator generator;
+    auto records = generator.generate(100);
+    std::swap(records[10], records[50]);
+    const std::string file = write_file("unsorted.csv", records);
+
+    MboMerger merger({file});
+    std::size_t delivered = 0;
+    while (auto record = merger.next()) {
+        EXPECT_EQ(record->order_id, records[delivered].order_id);  // Single input: file order
+        EXPECT_EQ(merger.last_input(), 0u);
+        delivered++;
+    }
+    EXPECT_EQ(delivered, records.size());
+    EXPECT_GE(merger.stats().out_of_order[0], 1u);
+    EXPECT_THROW(MboMerger(std::vector<std::string>{}), std::runtime_error);
+}
+
+} // namespace test
+} // namespace orderbook
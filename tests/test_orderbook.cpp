@@ -1,10 +1,13 @@
 #include "orderbook.hpp"
+#include "market_generator.hpp"
 #include <gtest/gtest.h>
 #include <chrono>
+#include <cstring>
 #include <random>
 #include <iomanip>
 #include <thread>
 #include <future>
+#include <sstream>
 
 namespace orderbook {
 namespace test {
@@ -205,24 +208,13 @@ TEST_F(OrderbookTest, MultiplePriceLevels) {
 TEST_F(OrderbookTest, PerformanceBenchmark) {
     constexpr std::size_t num_orders = 10000;
     
-    // Generate random orders
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<price_t> price_dist(900000, 1100000);
-    std::uniform_int_distribution<size_t> size_dist(1, 1000);
-    std::uniform_int_distribution<order_id_t> id_dist(1, 1000000);
+    // Generate a realistic add/cancel/trade flow
+    MarketGenerator generator;
+    const auto records = generator.generate(num_orders);
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    for (std::size_t i = 0; i < num_orders; ++i) {
-        MBORecord record;
-        record.action = Action::ADD;
-        record.side = (i % 2 == 0) ? Side::BID : Side::ASK;
-        record.price = price_dist(gen);
-        record.size = size_dist(gen);
-        record.order_id = id_dist(gen);
-        record.symbol = "PERF";
-        
+    for (const auto& record : records) {
         orderbook_->process_mbo_record(record);
     }
     
@@ -300,5 +292,323 @@ TEST_F(OrderbookTest, ThreadSafety) {
     EXPECT_GT(throughput, 1000.0);
 }
 
+TEST_F(OrderbookTest, AskLevelsBestFirst) {
+    const price_t prices[] = {1030000, 1010000, 1020000};
+    order_id_t order_id = 1;
+    for (price_t price : prices) {
+        MBORecord record;
+        record.action = Action::ADD;
+        record.side = Side::ASK;
+        record.price = price;
+        record.size = 100;
+        record.order_id = order_id++;
+        orderbook_->process_mbo_record(record);
+    }
+    
+    // Lowest ask first, unlike the bid side
+    auto asks = orderbook_->top_levels(Side::ASK);
+    EXPECT_EQ(asks[0].price, 1010000);
+    EXPECT_EQ(asks[1].price, 1020000);
+    EXPECT_EQ(asks[2].price, 1030000);
+    EXPECT_EQ(asks[3].price, 0);
+}
+
+TEST_F(OrderbookTest, ModifySizeInPlace) {
+    MBORecord record;
+    record.side = Side::BID;
+    record.price = 1000000;
+    record.size = 100;
+    for (order_id_t order_id : {1u, 2u}) {
+        record.action = Action::ADD;
+        record.order_id = order_id;
+        orderbook_->process_mbo_record(record);
+    }
+    
+    record.action = Action::MODIFY;
+    record.order_id = 1;
+    record.size = 40;
+    orderbook_->process_mbo_record(record);
+    
+    auto bids = orderbook_->top_levels(Side::BID);
+    EXPECT_EQ(bids[0].price, 1000000);
+    EXPECT_EQ(bids[0].size, 140);
+    EXPECT_EQ(bids[0].count, 2);
+    EXPECT_EQ(orderbook_->find_order(1)->size, 40);
+    EXPECT_EQ(orderbook_->level_count(), 1u);
+    
+    // Size zero removes the order
+    record.size = 0;
+    orderbook_->process_mbo_record(record);
+    EXPECT_FALSE(orderbook_->find_order(1));
+    EXPECT_EQ(orderbook_->top_levels(Side::BID)[0].size, 100);
+}
+
+TEST_F(OrderbookTest, ModifyMovesBetweenLevels) {
+    MBORecord record;
+    record.action = Action::ADD;
+    record.side = Side::ASK;
+    record.price = 1010000;
+    record.size = 100;
+    record.order_id = 7;
+    orderbook_->process_mbo_record(record);
+    
+    record.action = Action::MODIFY;
+    record.price = 1020000;
+    record.size = 80;
+    orderbook_->process_mbo_record(record);
+    
+    auto asks = orderbook_->top_levels(Side::ASK);
+    EXPECT_EQ(asks[0].price, 1020000);
+    EXPECT_EQ(asks[0].size, 80);
+    EXPECT_EQ(asks[0].count, 1);
+    EXPECT_EQ(asks[1].price, 0);
+    EXPECT_EQ(orderbook_->find_order(7)->price, 1020000);
+    
+    // An order the book has never seen is added
+    record.order_id = 8;
+    record.price = 1030000;
+    orderbook_->process_mbo_record(record);
+    EXPECT_EQ(orderbook_->order_count(), 2u);
+    EXPECT_EQ(orderbook_->top_levels(Side::ASK)[1].price, 1030000);
+}
+
+TEST_F(OrderbookTest, ModifyChangingSideMovesOrder) {
+    MBORecord record;
+    record.action = Action::ADD;
+    record.side = Side::BID;
+    record.price = 1000000;
+    record.size = 100;
+    record.order_id = 9;
+    orderbook_->process_mbo_record(record);
+    
+    // Cancelled on the bid side, added on the ask side
+    record.action = Action::MODIFY;
+    record.side = Side::ASK;
+    record.price = 1010000;
+    record.size = 60;
+    orderbook_->process_mbo_record(record);
+    EXPECT_EQ(orderbook_->order_count(), 1u);
+    EXPECT_EQ(orderbook_->level_count(), 1u);
+    EXPECT_EQ(orderbook_->top_levels(Side::BID)[0].price, 0);
+    EXPECT_EQ(orderbook_->top_levels(Side::ASK)[0].price, 1010000);
+    EXPECT_EQ(orderbook_->top_levels(Side::ASK)[0].size, 60u);
+    auto order = orderbook_->find_order(9);
+    ASSERT_TRUE(order.has_value());
+    EXPECT_EQ(order->side, Side::ASK);
+    EXPECT_EQ(order->size, 60u);
+}
+
+TEST_F(OrderbookTest, ClearMidStream) {
+    MarketGenerator generator;
+    for (const auto& record : generator.generate(5000)) {
+        orderbook_->process_mbo_record(record);
+    }
+    ASSERT_GT(orderbook_->order_count(), 0u);
+    
+    MBORecord clear;
+    clear.action = Action::CLEAR;
+    clear.side = Side::NEUTRAL;
+    clear.sequence = 5001;
+    orderbook_->process_mbo_record(clear);
+    EXPECT_EQ(orderbook_->order_count(), 0u);
+    EXPECT_EQ(orderbook_->level_count(), 0u);
+    EXPECT_EQ(orderbook_->top_levels(Side::BID)[0].price, 0);
+    
+    // The reset tables take new orders as usual
+    MBORecord add;
+    add.action = Action::ADD;
+    add.side = Side::BID;
+    add.price = 1000000;
+    add.size = 100;
+    add.order_id = 1;
+    orderbook_->process_mbo_record(add);
+    EXPECT_EQ(orderbook_->top_levels(Side::BID)[0].size, 100);
+    EXPECT_EQ(orderbook_->order_count(), 1u);
+}
+
+TEST_F(OrderbookTest, BulkSnapshotMatchesPerRecordAdds) {
+    MarketGenerator generator;
+    const auto records = generator.generate(6000);
+    
+    // Stream: live records, a clear plus a snapshot of the book at that
+    // point, then the rest of the live records
+    Orderbook source;
+    for (std::size_t i = 0; i < 3000; ++i) {
+        source.process_mbo_record(records[i]);
+    }
+    std::vector<MBORecord> stream(records.begin(), records.begin() + 3000);
+    MBORecord clear;
+    clear.action = Action::CLEAR;
+    clear.side = Side::NEUTRAL;
+    clear.flags = FLAG_SNAPSHOT;
+    stream.push_back(clear);
+    for (Side side : {Side::BID, Side::ASK}) {
+        for (const auto& level : source.book_levels(side, 0, true)) {
+            for (const auto& [order_id, size] : level.orders) {
+                MBORecord add;
+                add.action = Action::ADD;
+                add.side = side;
+                add.price = level.price;
+                add.size = size;
+                add.order_id = order_id;
+                add.flags = FLAG_SNAPSHOT;
+                stream.push_back(add);
+            }
+        }
+    }
+    stream.back().flags |= FLAG_LAST;
+    const std::size_t snapshot_last = stream.size() - 1;
+    stream.insert(stream.end(), records.begin() + 3000, records.end());
+    
+    Orderbook bulk;
+    bulk.set_bulk_snapshots(true);
+    for (std::size_t i = 0; i < stream.size(); ++i) {
+        orderbook_->process_mbo_record(stream[i]);
+        bulk.process_mbo_record(stream[i]);
+        if (i == snapshot_last - 1) {
+            // Adds are staged until the snapshot's last record
+            EXPECT_EQ(bulk.order_count(), 0u);
+        }
+    }
+    
+    for (Side side : {Side::BID, Side::ASK}) {
+        const auto expected = orderbook_->book_levels(side, 0, true);
+        const auto actual = bulk.book_levels(side, 0, true);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(actual[i].price, expected[i].price);
+            EXPECT_EQ(actual[i].size, expected[i].size);
+            EXPECT_EQ(actual[i].count, expected[i].count);
+            EXPECT_EQ(actual[i].orders, expected[i].orders);
+        }
+    }
+    EXPECT_EQ(bulk.order_count(), orderbook_->order_count());
+}
+
+TEST_F(OrderbookTest, CheckpointRoundTrip) {
+    MarketGenerator generator;
+    const auto records = generator.generate(20000);
+    const std::size_t split = records.size() / 2;
+    for (std::size_t i = 0; i < split; ++i) {
+        orderbook_->process_mbo_record(records[i]);
+    }
+    
+    CheckpointPosition position;
+    position.byte_offset = 123456;
+    position.records = split;
+    position.sequence = records[split - 1].sequence;
+    position.ts_event = records[split - 1].timestamp.ts_event;
+    std::stringstream image;
+    orderbook_->save_checkpoint(image, position);
+    
+    Orderbook restored;
+    const auto loaded = restored.load_checkpoint(image);
+    EXPECT_EQ(loaded.byte_offset, position.byte_offset);
+    EXPECT_EQ(loaded.records, position.records);
+    EXPECT_EQ(loaded.sequence, position.sequence);
+    EXPECT_EQ(loaded.ts_event, position.ts_event);
+    EXPECT_EQ(restored.order_count(), orderbook_->order_count());
+    EXPECT_EQ(restored.level_count(), orderbook_->level_count());
+    
+    // Continuing both books must give identical snapshots (pending trades included)
+    for (std::size_t i = split; i < records.size(); ++i) {
+        orderbook_->process_mbo_record(records[i]);
+        restored.process_mbo_record(records[i]);
+        const auto expected = orderbook_->generate_mbp_record(records[i]);
+        const auto actual = restored.generate_mbp_record(records[i]);
+        ASSERT_EQ(actual.bid_levels, expected.bid_levels) << "record " << i;
+        ASSERT_EQ(actual.ask_levels, expected.ask_levels) << "record " << i;
+    }
+}
+
+TEST_F(OrderbookTest, CheckpointLoadDiscardsStagedSnapshot) {
+    MarketGenerator generator;
+    for (const auto& record : generator.generate(2000)) {
+        orderbook_->process_mbo_record(record);
+    }
+    std::stringstream image;
+    orderbook_->save_checkpoint(image, CheckpointPosition{});
+
+    // Load while two snapshot adds are staged
+    Orderbook restored;
+    restored.set_bulk_snapshots(true);
+    MBORecord add{};
+    add.action = Action::ADD;
+    add.side = Side::BID;
+    add.price = 1000000;
+    add.size = 100;
+    add.flags = FLAG_SNAPSHOT;
+    for (order_id_t order_id : {900000001ULL, 900000002ULL}) {
+        add.order_id = order_id;
+        restored.process_mbo_record(add);
+    }
+    ASSERT_TRUE(restored.snapshot_pending());
+    restored.load_checkpoint(image);
+    EXPECT_FALSE(restored.snapshot_pending());
+
+    // The next snapshot builds only its own adds on the restored image
+    add.order_id = 900000003;
+    add.flags = FLAG_SNAPSHOT | FLAG_LAST;
+    restored.process_mbo_record(add);
+    EXPECT_EQ(restored.order_count(), orderbook_->order_count() + 1);
+    EXPECT_FALSE(restored.find_order(900000001));
+    EXPECT_TRUE(restored.find_order(900000003));
+}
+
+TEST_F(OrderbookTest, CheckpointRejectsCorruptImage) {
+    MarketGenerator generator;
+    for (const auto& record : generator.generate(2000)) {
+        orderbook_->process_mbo_record(record);
+    }
+    std::stringstream image;
+    orderbook_->save_checkpoint(image, CheckpointPosition{});
+    const std::string bytes = image.str();
+    const auto orders = orderbook_->order_count();
+    
+    std::string corrupt = bytes;
+    corrupt[bytes.size() / 2] ^= 0x40;
+    std::istringstream corrupt_input(corrupt);
+    EXPECT_THROW(orderbook_->load_checkpoint(corrupt_input), std::runtime_error);
+    
+    std::istringstream truncated_input(bytes.substr(0, bytes.size() - 3));
+    EXPECT_THROW(orderbook_->load_checkpoint(truncated_input), std::runtime_error);
+
+    // A count the rest of the image cannot hold is rejected, not allocated
+    std::string inflated = bytes;
+    const std::uint64_t huge_count = 1ull << 31;
+    const std::size_t first_order_count = 8 + 32 + 8 + 8 + 4 + 4;  // Header, position, level fields
+    std::memcpy(&inflated[first_order_count], &huge_count, sizeof(huge_count));
+    std::istringstream inflated_input(inflated);
+    EXPECT_THROW(orderbook_->load_checkpoint(inflated_input), std::runtime_error);
+    
+    // A failed load leaves the book as it was
+    EXPECT_EQ(orderbook_->order_count(), orders);
+}
+
+TEST(BookEngineTest, RegistryCreatesMapEngine) {
+    const auto& engines = registered_book_engines();
+    ASSERT_FALSE(engines.empty());
+    EXPECT_EQ(engines.front().name, "map");
+    EXPECT_THROW(create_book_engine("no-such-engine"), std::invalid_argument);
+    
+    auto engine = create_book_engine("map");
+    MBORecord record;
+    record.action = Action::ADD;
+    record.side = Side::BID;
+    record.price = 1000000;
+    record.size = 100;
+    record.order_id = 42;
+    engine->apply(record);
+    
+    auto order = engine->find_order(42);
+    ASSERT_TRUE(order.has_value());
+    EXPECT_EQ(order->side, Side::BID);
+    EXPECT_EQ(order->price, 1000000);
+    EXPECT_EQ(order->size, 100u);
+    EXPECT_FALSE(engine->find_order(43).has_value());
+    EXPECT_EQ(engine->order_count(), 1u);
+    EXPECT_EQ(engine->top_levels(Side::BID)[0].size, 100u);
+}
+
 } // namespace test
 } // namespace orderbook 
\ No newline at end of file
@@ -0,0 +1,468 @@
+#include "orderbook.hpp"
+#include "checkpoint_chain.hpp"
+#include "market_generator.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace orderbook {
+namespace test {
+
+namespace fs = std::filesystem;
+
+class ProcessorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / ("processor_test_" + std::to_string(::getpid()));
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    static std::vector<std::string> read_lines(const std::string& file) {
+        std::ifstream input(file);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(input, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    fs::path dir_;
+};
+
+TEST_F(ProcessorTest, ResumeFromCheckpointMatchesFullReplay) {
+    MarketGenerator generator;
+    std::ostringstream csv;
+    generator.write_csv(csv, 30000);
+    const std::string text = csv.str();
+
+    // Prefix file: header plus the first 12000 records
+    std::size_t prefix_end = 0;
+    for (int newlines = 0; newlines < 12001; ++newlines) {
+        prefix_end = text.find('\n', prefix_end) + 1;
+    }
+    std::ofstream(path("full.csv")) << text;
+    std::ofstream(path("prefix.csv")) << text.substr(0, prefix_end);
+
+    OrderbookProcessor full;
+    full.process_file(path("full.csv"), path("full_mbp.csv"));
+
+    OrderbookProcessor first;
+    first.set_buffer_size(1000);
+    first.set_checkpoint_output(path("book.ckpt"), 5000);
+    first.process_file(path("prefix.csv"), path("prefix_mbp.csv"));
+    EXPECT_EQ(first.position().byte_offset, prefix_end);
+    EXPECT_EQ(first.position().records, 12000u);
+
+    OrderbookProcessor resumed;
+    resumed.set_resume_checkpoint(path("book.ckpt"));
+    resumed.process_file(path("full.csv"), path("resumed_mbp.csv"));
+    EXPECT_EQ(resumed.position().records, 30000u);
+
+    // Header plus the rows after the checkpoint, identical to the full replay
+    const auto expected = read_lines(path("full_mbp.csv"));
+    const auto actual = read_lines(path("resumed_mbp.csv"));
+    ASSERT_EQ(expected.size(), 30001u);
+    ASSERT_EQ(actual.size(), 18001u);
+    EXPECT_EQ(actual[0], expected[0]);
+    for (std::size_t i = 1; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i], expected[i + 12000]) << "row " << i;
+    }
+}
+
+TEST_F(ProcessorTest, ParallelReplayMatchesSequential) {
+    MarketGenerator generator;
+    std::ofstream(path("mbo.csv")) << [&] {
+        std::ostringstream csv;
+        generator.write_csv(csv, 20000);
+        return csv.str();
+    }();
+
+    OrderbookProcessor sequential;
+    sequential.process_file(path("mbo.csv"), path("sequential_mbp.csv"));
+
+    for (std::size_t segments : {1, 4, 7}) {
+        OrderbookProcessor parallel;
+        parallel.set_thread_count(3);
+        parallel.process_file_parallel(path("mbo.csv"), path("parallel_mbp.csv"), segments);
+        EXPECT_EQ(parallel.position().records, 20000u);
+        EXPECT_EQ(parallel.position().byte_offset, fs::file_size(path("mbo.csv")));
+
+        const auto expected = read_lines(path("sequential_mbp.csv"));
+        const auto actual = read_lines(path("parallel_mbp.csv"));
+        ASSERT_EQ(actual.size(), expected.size()) << segments << " segments";
+        EXPECT_TRUE(actual == expected) << segments << " segments";
+        EXPECT_FALSE(fs::exists(path("parallel_mbp.csv.part0")));
+    }
+}
+
+TEST_F(ProcessorTest, ParallelHonoursStartAndStateOnly) {
+    MarketGenerator generator;
+    std::ofstream(path("mbo.csv")) << [&] {
+        std::ostringstream csv;
+        generator.write_csv(csv, 20000);
+        return csv.str();
+    }();
+    const auto input = read_lines(path("mbo.csv"));
+    const auto start = CSVParser::parse_mbo_line(input[12000]);
+    ASSERT_TRUE(start.has_value());
+
+    for (bool by_sequence : {false, true}) {
+        OrderbookProcessor sequential;
+        OrderbookProcessor parallel;
+        for (OrderbookProcessor* processor : {&sequential, &parallel}) {
+            if (by_sequence) {
+                processor->set_output_start(std::nullopt, start->sequence);
+            } else {
+                processor->set_output_start(start->timestamp.ts_event);
+            }
+        }
+        sequential.process_file(path("mbo.csv"), path("sequential_mbp.csv"));
+        parallel.set_thread_count(3);
+        parallel.process_file_parallel(path("mbo.csv"), path("parallel_mbp.csv"), 4);
+
+        const auto expected = read_lines(path("sequential_mbp.csv"));
+        const auto actual = read_lines(path("parallel_mbp.csv"));
+        ASSERT_LT(expected.size(), input.size());
+        ASSERT_EQ(actual.size(), expected.size());
+        EXPECT_TRUE(actual == expected);
+    }
+
+    OrderbookProcessor state_only;
+    state_only.set_state_only(true);
+    state_only.set_checkpoint_output(path("state.ckpt"));
+    state_only.process_file_parallel(path("mbo.csv"), path("unused_mbp.csv"), 4);
+    EXPECT_FALSE(fs::exists(path("unused_mbp.csv")));
+    EXPECT_FALSE(fs::exists(path("unused_mbp.csv.part0")));
+    Orderbook restored;
+    EXPECT_EQ(restored.load_checkpoint(path("state.ckpt")).records, 20000u);
+}
+
+TEST_F(ProcessorTest, ParallelWritesCheckpointsAndChain) {
+    MarketGenerator generator;
+    std::ofstream(path("mbo.csv")) << [&] {
+        std::ostringstream csv;
+        generator.write_csv(csv, 20000);
+        return csv.str();
+    }();
+
+    OrderbookProcessor sequential;
+    sequential.set_buffer_size(1000);
+    sequential.set_checkpoint_output(path("sequential.ckpt"), 3000);
+    sequential.set_checkpoint_chain(path("sequential_chain"), 3000, 3);
+    sequential.process_file(path("mbo.csv"), path("sequential_mbp.csv"));
+
+    OrderbookProcessor parallel;
+    parallel.set_buffer_size(1000);
+    parallel.set_thread_count(3);
+    parallel.set_checkpoint_output(path("parallel.ckpt"), 3000);
+    parallel.set_checkpoint_chain(path("parallel_chain"), 3000, 3);
+    parallel.process_file_parallel(path("mbo.csv"), path("parallel_mbp.csv"), 4);
+
+    // Restore points at the same positions, each rebuilding the same book
+    CheckpointChain expected(path("sequential_chain"));
+    CheckpointChain actual(path("parallel_chain"));
+    ASSERT_EQ(actual.points().size(), expected.points().size());
+    ASSERT_GT(actual.points().size(), 5u);
+    for (std::size_t i = 0; i < actual.points().size(); ++i) {
+        EXPECT_EQ(actual.points()[i].position.byte_offset, expected.points()[i].position.byte_offset);
+        EXPECT_EQ(actual.points()[i].full, expected.points()[i].full);
+        Orderbook expected_book;
+        Orderbook actual_book;
+        expected.restore(expected_book, i);
+        actual.restore(actual_book, i);
+        EXPECT_EQ(actual_book.order_count(), expected_book.order_count());
+        EXPECT_EQ(actual_book.top_levels(Side::BID), expected_book.top_levels(Side::BID));
+        EXPECT_EQ(actual_book.top_levels(Side::ASK), expected_book.top_levels(Side::ASK));
+    }
+
+    // Resuming the parallel run's chain continues from its newest point
+    OrderbookProcessor resumed;
+    resumed.set_resume_chain(path("parallel_chain"));
+    resumed.process_file_parallel(path("mbo.csv"), path("resumed_mbp.csv"), 2);
+    EXPECT_EQ(resumed.position().records, 20000u);
+    EXPECT_EQ(read_lines(path("resumed_mbp.csv")).size(), 1u);
+}
+
+TEST_F(ProcessorTest, ParallelBulkSnapshotsMatchSequential) {
+    MarketGenerator generator;
+    const auto records = generator.generate(8000);
+    
+    // A clear and a snapshot of the book in the middle of the stream, long
+    // enough that segment boundaries and checkpoint chunks fall inside it
+    Orderbook source;
+    for (std::size_t i = 0; i < 4000; ++i) {
+        source.process_mbo_record(records[i]);
+    }
+    std::vector<MBORecord> stream(records.begin(), records.begin() + 4000);
+    MBORecord clear = records[3999];
+    clear.action = Action::CLEAR;
+    clear.side = Side::NEUTRAL;
+    clear.price = 0;
+    clear.size = 0;
+    clear.order_id = 0;
+    clear.flags = FLAG_SNAPSHOT;
+    stream.push_back(clear);
+    for (Side side : {Side::BID, Side::ASK}) {
+        for (const auto& level : source.book_levels(side, 0, true)) {
+            for (const auto& [order_id, size] : level.orders) {
+                MBORecord add = clear;
+                add.action = Action::ADD;
+                add.side = side;
+                add.price = level.price;
+                add.size = size;
+                add.order_id = order_id;
+                stream.push_back(add);
+            }
+        }
+    }
+    stream.back().flags |= FLAG_LAST;
+    ASSERT_GT(stream.size(), 4600u);
+    stream.insert(stream.end(), records.begin() + 4000, records.end());
+    {
+        std::ofstream output(path("mbo.csv"));
+        output << MarketGenerator::csv_header() << "\n";
+        for (const auto& record : stream) {
+            output << MarketGenerator::format_mbo_line(record) << "\n";
+        }
+    }
+    
+    for (std::size_t checkpoint_every : {0, 500}) {
+        OrderbookProcessor sequential;
+        sequential.set_bulk_snapshots(true);
+        sequential.set_buffer_size(500);
+        sequential.set_checkpoint_output(path("sequential.ckpt"), checkpoint_every);
+        sequential.process_file(path("mbo.csv"), path("sequential_mbp.csv"));
+        const auto expected = read_lines(path("sequential_mbp.csv"));
+        
+        for (std::size_t segments : {3, 8}) {
+            OrderbookProcessor parallel;
+            parallel.set_bulk_snapshots(true);
+            parallel.set_buffer_size(500);
+            parallel.set_thread_count(3);
+            parallel.set_checkpoint_output(path("parallel.ckpt"), checkpoint_every);
+            parallel.process_file_parallel(path("mbo.csv"), path("parallel_mbp.csv"), segments);
+            const auto actual = read_lines(path("parallel_mbp.csv"));
+            ASSERT_EQ(actual.size(), expected.size()) << segments << " segments";
+            EXPECT_TRUE(actual == expected) << segments << " segments, checkpoint every " << checkpoint_every;
+        }
+    }
+}
+
+TEST_F(ProcessorTest, EventBatchesWriteOneRowPerEvent) {
+    MarketGenerator generator;
+    const auto records = generator.generate(20000);
+    std::ofstream output(path("mbo.csv"));
+    output << MarketGenerator::csv_header() << "\n";
+    for (const auto& record : records) {
+        output << MarketGenerator::format_mbo_line(record) << "\n";
+    }
+    output.close();
+
+    OrderbookProcessor every_record;
+    every_record.process_file(path("mbo.csv"), path("all_mbp.csv"));
+
+    OrderbookProcessor batched;
+    batched.set_event_batches(true);
+    batched.process_file(path("mbo.csv"), path("batched_mbp.csv"));
+
+    // The rows kept are exactly those of the events' last records
+    const auto all = read_lines(path("all_mbp.csv"));
+    std::vector<std::string> expected{all[0]};
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        if (records[i].flags & FLAG_LAST) {
+            expected.push_back(all[i + 1]);
+        }
+    }
+    ASSERT_LT(expected.size(), all.size());
+    EXPECT_TRUE(read_lines(path("batched_mbp.csv")) == expected);
+    EXPECT_EQ(batched.suppressed_rows(), all.size() - expected.size());
+
+    OrderbookProcessor parallel;
+    parallel.set_event_batches(true);
+    parallel.process_file_parallel(path("mbo.csv"), path("parallel_mbp.csv"), 5);
+    EXPECT_TRUE(read_lines(path("parallel_mbp.csv")) == expected);
+    EXPECT_EQ(parallel.suppressed_rows(), batched.suppressed_rows());
+}
+
+TEST_F(ProcessorTest, DetectsSequenceGaps) {
+    MarketGenerator generator;
+    const auto records = generator.generate(5000);
+    std::ofstream output(path("mbo.csv"));
+    output << MarketGenerator::csv_header() << "\n";
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        if (i != 2000 && i != 2001) {
+            output << MarketGenerator::format_mbo_line(records[i]) << "\n";
+        }
+    }
+    output << MarketGenerator::format_mbo_line(records[10]) << "\n";
+    output.close();
+
+    std::vector<SequenceGap> gaps;
+    OrderbookProcessor processor;
+    processor.set_gap_handler([&](const SequenceGap& gap) { gaps.push_back(gap); });
+    processor.process_file(path("mbo.csv"), path("mbp.csv"));
+
+    // Two dropped records on the same channel are one gap, unless they
+    // straddle two channels; the replayed record is a duplicate
+    const auto stats = processor.sequence_tracker().stats();
+    EXPECT_EQ(stats.missing, 2u);
+    EXPECT_EQ(stats.gaps, records[2000].channel_id == records[2001].channel_id ? 1u : 2u);
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(gaps.size(), stats.gaps + stats.duplicates);
+    EXPECT_EQ(gaps.front().expected, records[2000].sequence);
+    EXPECT_FALSE(processor.sequence_tracker().book_valid());
+}
+
+TEST_F(ProcessorTest, ReorderWindowRestoresCaptureOrder) {
+    MarketGenerator generator;
+    auto records = generator.generate(10000);
+    auto write = [&](const std::string& name) {
+        std::ofstream output(path(name));
+        output << MarketGenerator::csv_header() << "\n";
+        for (const auto& record : records) {
+            output << MarketGenerator::format_mbo_line(record) << "\n";
+        }
+    };
+    write("ordered.csv");
+
+    // Swap neighbours every so often, as an interleaving capture would
+    std::size_t swapped = 0;
+    for (std::size_t i = 0; i + 1 < records.size(); i += 37) {
+        if (records[i].timestamp.ts_recv < records[i + 1].timestamp.ts_recv) {
+            std::swap(records[i], records[i + 1]);
+            swapped++;
+        }
+    }
+    write("swapped.csv");
+
+    OrderbookProcessor ordered;
+    ordered.process_file(path("ordered.csv"), path("ordered_mbp.csv"));
+
+    OrderbookProcessor reordered;
+    ReorderConfig config;
+    config.max_records = 8;
+    reordered.set_reorder(config);
+    reordered.process_file(path("swapped.csv"), path("reordered_mbp.csv"));
+
+    EXPECT_TRUE(read_lines(path("reordered_mbp.csv")) == read_lines(path("ordered_mbp.csv")));
+    EXPECT_EQ(reordered.reorder_stats().late, swapped);
+    EXPECT_EQ(reordered.reorder_stats().dropped, 0u);
+    EXPECT_EQ(reordered.position().records, 10000u);
+
+    reordered.set_checkpoint_output(path("book.ckpt"), 1000);
+    EXPECT_THROW(reordered.process_file(path("swapped.csv"), path("reordered_mbp.csv")), std::runtime_error);
+}
+
+TEST_F(ProcessorTest, FastForwardWritesRowsFromStart) {
+    MarketGenerator generator;
+    std::ofstream(path("mbo.csv")) << [&] {
+        std::ostringstream csv;
+        generator.write_csv(csv, 10000);
+        return csv.str();
+    }();
+
+    OrderbookProcessor full;
+    full.process_file(path("mbo.csv"), path("full_mbp.csv"));
+    const auto expected = read_lines(path("full_mbp.csv"));
+
+    const auto input = read_lines(path("mbo.csv"));
+    const auto start = CSVParser::parse_mbo_line(input[6000]);
+    ASSERT_TRUE(start.has_value());
+
+    OrderbookProcessor by_sequence;
+    by_sequence.set_output_start(std::nullopt, start->sequence);
+    by_sequence.process_file(path("mbo.csv"), path("sequence_mbp.csv"));
+    const auto actual = read_lines(path("sequence_mbp.csv"));
+    ASSERT_EQ(actual.size(), expected.size() - 5999);
+    EXPECT_EQ(actual[0], expected[0]);
+    EXPECT_TRUE(std::equal(actual.begin() + 1, actual.end(), expected.begin() + 6000));
+
+    OrderbookProcessor by_time;
+    by_time.set_output_start(start->timestamp.ts_event);
+    by_time.process_file(path("mbo.csv"), path("time_mbp.csv"));
+    const auto timed = read_lines(path("time_mbp.csv"));
+    ASSERT_GE(timed.size(), actual.size());
+    EXPECT_EQ(timed.back(), expected.back());
+}
+
+TEST_F(ProcessorTest, StateOnlyBuildsCheckpointWithoutOutput) {
+    MarketGenerator generator;
+    std::ofstream(path("mbo.csv")) << [&] {
+        std::ostringstream csv;
+        generator.write_csv(csv, 10000);
+        return csv.str();
+    }();
+
+    OrderbookProcessor full;
+    full.set_checkpoint_output(path("full.ckpt"));
+    full.process_file(path("mbo.csv"), path("full_mbp.csv"));
+
+    OrderbookProcessor state_only;
+    state_only.set_state_only(true);
+    state_only.set_checkpoint_output(path("state.ckpt"));
+    state_only.process_file(path("mbo.csv"), path("unused_mbp.csv"));
+    EXPECT_FALSE(fs::exists(path("unused_mbp.csv")));
+
+    Orderbook expected;
+    Orderbook actual;
+    const auto expected_position = expected.load_checkpoint(path("full.ckpt"));
+    const auto actual_position = actual.load_checkpoint(path("state.ckpt"));
+    EXPECT_EQ(actual_position.byte_offset, expected_position.byte_offset);
+    EXPECT_EQ(actual_position.records, expected_position.records);
+    EXPECT_EQ(actual.order_count(), expected.order_count());
+    EXPECT_EQ(actual.top_levels(Side::BID), expected.top_levels(Side::BID));
+    EXPECT_EQ(actual.top_levels(Side::ASK), expected.top_levels(Side::ASK));
+}
+
+TEST_F(ProcessorTest, BackgroundCheckpointMatchesSynchronous) {
+    MarketGenerator generator;
+    Orderbook book;
+    for (const auto& record : generator.generate(5000)) {
+        book.process_mbo_record(record);
+    }
+    CheckpointPosition position;
+    position.records = 5000;
+    book.save_checkpoint(path("sync.ckpt"), position);
+
+    BackgroundCheckpointer checkpointer;
+    EXPECT_TRUE(checkpointer.start(book, path("background.ckpt"), position));
+    // The parent may keep mutating its book; the child wrote the forked state
+    for (const auto& record : generator.generate(1000)) {
+        book.process_mbo_record(record);
+    }
+    checkpointer.wait();
+    EXPECT_EQ(checkpointer.stats().completed, 1u);
+    EXPECT_EQ(checkpointer.stats().failed, 0u);
+
+    std::ifstream sync_file(path("sync.ckpt"), std::ios::binary);
+    std::ifstream background_file(path("background.ckpt"), std::ios::binary);
+    const std::string sync_image((std::istreambuf_iterator<char>(sync_file)), std::istreambuf_iterator<char>());
+    const std::string background_image((std::istreambuf_iterator<char>(background_file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(background_image, sync_image);
+}
+
+TEST_F(ProcessorTest, ResumeRejectsOffsetOutsideInput) {
+    std::ofstream(path("short.csv")) << "header\n";
+
+    Orderbook book;
+    CheckpointPosition position;
+    position.byte_offset = 1 << 20;
+    book.save_checkpoint(path("book.ckpt"), position);
+
+    OrderbookProcessor processor;
+    processor.set_resume_checkpoint(path("book.ckpt"));
+    EXPECT_THROW(processor.process_file(path("short.csv"), path("out.csv")), std::runtime_error);
+}
+
+} // namespace test
+} // namespace orderbook
@@ -0,0 +1,94 @@
+#include "reorder_buffer.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+namespace orderbook {
+namespace test {
+
+namespace {
+
+MBORecord record_at(timestamp_t ts_recv, sequence_t sequence) {
+    MBORecord record;
+    record.timestamp.ts_recv = ts_recv;
+    record.timestamp.ts_event = ts_recv;
+    record.sequence = sequence;
+    return record;
+}
+
+} // namespace
+
+TEST(ReorderBufferTest, CountWindowRestoresOrder) {
+    ReorderConfig config;
+    config.key = ReorderKey::SEQUENCE;
+    config.max_records = 3;
+    ReorderBuffer buffer(config);
+
+    std::vector<sequence_t> released;
+    auto release = [&](const MBORecord& record) { released.push_back(record.sequence); };
+    for (sequence_t sequence : {1u, 3u, 2u, 4u, 7u, 5u, 6u, 8u}) {
+        buffer.push(record_at(0, sequence), release);
+        EXPECT_LE(buffer.held(), 3u);
+    }
+    buffer.flush(release);
+
+    EXPECT_EQ(released, (std::vector<sequence_t>{1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(buffer.stats().records, 8u);
+    EXPECT_EQ(buffer.stats().late, 3u);
+    EXPECT_EQ(buffer.stats().dropped, 0u);
+    EXPECT_EQ(buffer.stats().max_held, 4u);
+}
+
+TEST(ReorderBufferTest, UnsequencedClearKeepsItsPlace) {
+    ReorderConfig config;
+    config.key = ReorderKey::SEQUENCE;
+    config.max_records = 2;
+    ReorderBuffer buffer(config);
+
+    std::vector<MBORecord> released;
+    auto release = [&](const MBORecord& record) { released.push_back(record); };
+    MBORecord clear = record_at(0, 0);
+    clear.action = Action::CLEAR;
+    for (const MBORecord& record : {record_at(0, 1), record_at(0, 3), record_at(0, 2), clear,
+                                    record_at(0, 5), record_at(0, 4), record_at(0, 6)}) {
+        buffer.push(record, release);
+    }
+    buffer.flush(release);
+
+    // Released after everything that arrived before it, never dropped
+    ASSERT_EQ(released.size(), 7u);
+    EXPECT_EQ(released[3].action, Action::CLEAR);
+    std::vector<sequence_t> sequences;
+    for (const auto& record : released) {
+        sequences.push_back(record.sequence);
+    }
+    EXPECT_EQ(sequences, (std::vector<sequence_t>{1, 2, 3, 0, 4, 5, 6}));
+    EXPECT_EQ(buffer.stats().late, 2u);
+    EXPECT_EQ(buffer.stats().dropped, 0u);
+}
+
+TEST(ReorderBufferTest, DistanceWindowDropsTooLate) {
+    ReorderConfig config;
+    config.max_records = 0;
+    config.max_distance = 100;
+    ReorderBuffer buffer(config);
+
+    std::vector<timestamp_t> released;
+    auto release = [&](const MBORecord& record) { released.push_back(record.timestamp.ts_recv); };
+    buffer.push(record_at(1000, 1), release);
+    buffer.push(record_at(1050, 2), release);
+    buffer.push(record_at(1020, 3), release);   // Late, still in the window
+    buffer.push(record_at(1200, 4), release);   // Releases everything up to 1100
+    buffer.push(record_at(1010, 5), release);   // Behind a released key: dropped
+    buffer.push(record_at(1200, 6), release);   // Equal keys keep arrival order
+    buffer.flush(release);
+
+    EXPECT_EQ(released, (std::vector<timestamp_t>{1000, 1020, 1050, 1200, 1200}));
+    EXPECT_EQ(buffer.stats().late, 2u);
+    EXPECT_EQ(buffer.stats().dropped, 1u);
+
+    EXPECT_THROW(ReorderBuffer(ReorderConfig{ReorderKey::TS_RECV, 0, 0}), std::runtime_error);
+}
+
+} // namespace test
+} // namespace orderbook
@@ -0,0 +1,134 @@
+#include "replay_index.hpp"
+#include "orderbook.hpp"
+#include "market_generator.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace orderbook {
+namespace test {
+
+namespace fs = std::filesystem;
+
+class ReplayIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / ("replay_index_test_" + std::to_string(::getpid()));
+        fs::create_directories(dir_);
+
+        MarketGenerator generator;
+        std::ofstream output(path("mbo.csv"));
+        generator.write_csv(output, 20000);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    std::string path(const std::string& name) const { return (dir_ / name).string(); }
+
+    static std::vector<std::string> read_lines(const std::string& file) {
+        std::ifstream input(file);
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(input, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    fs::path dir_;
+};
+
+TEST_F(ReplayIndexTest, EntriesPointAtRecordLines) {
+    IndexConfig config;
+    config.every_records = 1000;
+    config.every_ms = 50;
+    const auto index = ReplayIndex::build(path("mbo.csv"), path("mbo.idx"), config);
+
+    const auto& entries = index.entries();
+    ASSERT_GE(entries.size(), 20u);
+    EXPECT_EQ(entries.front().byte_offset, index.data_offset());
+    EXPECT_EQ(entries.front().records, 0u);
+
+    std::ifstream input(path("mbo.csv"));
+    std::string line;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (i > 0) {
+            EXPECT_LE(entries[i].records - entries[i - 1].records, 1000u);
+            EXPECT_GE(entries[i].ts_event, entries[i - 1].ts_event);
+            EXPECT_GT(entries[i].byte_offset, entries[i - 1].byte_offset);
+        }
+        input.seekg(static_cast<std::streamoff>(entries[i].byte_offset));
+        ASSERT_TRUE(std::getline(input, line));
+        auto record = CSVParser::parse_mbo_line(line);
+        ASSERT_TRUE(record.has_value());
+        EXPECT_LE(record->timestamp.ts_event, entries[i].ts_event);
+    }
+}
+
+TEST_F(ReplayIndexTest, LoadAndSeek) {
+    IndexConfig config;
+    config.every_records = 500;
+    config.every_ms = 0;
+    const auto built = ReplayIndex::build(path("mbo.csv"), path("mbo.idx"), config);
+    const auto index = ReplayIndex::load(path("mbo.idx"));
+    ASSERT_EQ(index.entries().size(), built.entries().size());
+    EXPECT_EQ(index.entries().size(), 40u);
+    EXPECT_EQ(index.input_size(), fs::file_size(path("mbo.csv")));
+
+    const auto& target = index.entries()[17];
+    auto entry = index.seek_time(target.ts_event);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_LT(entry->ts_event, target.ts_event);
+    EXPECT_FALSE(index.seek_time(index.entries().front().ts_event).has_value());
+
+    entry = index.seek_sequence(target.sequence);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->records, index.entries()[16].records);
+
+    std::ofstream(path("bad.idx")) << "not an index";
+    EXPECT_THROW(ReplayIndex::load(path("bad.idx")), std::runtime_error);
+}
+
+TEST_F(ReplayIndexTest, WindowFromCheckpointMatchesFullReplay) {
+    IndexConfig config;
+    config.every_records = 1000;
+    config.every_ms = 0;
+    config.checkpoint_every = 3;
+    const auto index = ReplayIndex::build(path("mbo.csv"), path("mbo.idx"), config);
+
+    OrderbookProcessor full;
+    full.process_file(path("mbo.csv"), path("full_mbp.csv"));
+    const auto expected = read_lines(path("full_mbp.csv"));
+
+    // Window well past the first checkpoint
+    const auto input = read_lines(path("mbo.csv"));
+    const timestamp_t t0 = CSVParser::parse_mbo_line(input[12345])->timestamp.ts_event;
+    const timestamp_t t1 = CSVParser::parse_mbo_line(input[15000])->timestamp.ts_event;
+    ASSERT_TRUE(index.seek_checkpoint(t0).has_value());
+
+    OrderbookProcessor window;
+    window.process_window(path("mbo.csv"), path("window_mbp.csv"), index, t0, t1);
+    const auto actual = read_lines(path("window_mbp.csv"));
+
+    std::vector<std::string> wanted = {expected[0]};
+    bool started = false;
+    for (std::size_t i = 1; i < input.size(); ++i) {
+        const timestamp_t ts = CSVParser::parse_mbo_line(input[i])->timestamp.ts_event;
+        started = started || ts >= t0;
+        if (started && ts > t1) {
+            break;
+        }
+        if (started) {
+            wanted.push_back(expected[i]);
+        }
+    }
+    ASSERT_GT(wanted.size(), 2000u);
+    EXPECT_EQ(actual, wanted);
+}
+
+} // namespace test
+} // namespace orderbook
@@ -0,0 +1,59 @@
+#include "sequence_tracker.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace orderbook {
+namespace test {
+
+TEST(SequenceTrackerTest, InSequenceAndRepeatedMessage) {
+    SequenceTracker tracker;
+    for (sequence_t sequence : {100u, 101u, 101u, 102u, 103u}) {
+        EXPECT_EQ(tracker.check(1, 7, sequence), SequenceStatus::IN_SEQUENCE);
+    }
+    EXPECT_EQ(tracker.check(1, 7, 0), SequenceStatus::UNSEQUENCED);
+    EXPECT_EQ(tracker.check(1, 7, 104), SequenceStatus::IN_SEQUENCE);
+
+    const auto stats = tracker.stats();
+    EXPECT_EQ(stats.gaps, 0u);
+    EXPECT_EQ(stats.duplicates, 0u);
+    EXPECT_EQ(stats.channels, 1u);
+    EXPECT_TRUE(tracker.book_valid());
+}
+
+TEST(SequenceTrackerTest, GapsAndDuplicatesPerChannel) {
+    SequenceTracker tracker;
+    std::vector<SequenceGap> events;
+    tracker.set_gap_handler([&](const SequenceGap& gap) { events.push_back(gap); });
+
+    tracker.check(2, 1, 10);
+    tracker.check(2, 300, 50);   // Channels are independent
+    EXPECT_EQ(tracker.check(2, 1, 14), SequenceStatus::GAP);
+    EXPECT_EQ(tracker.check(2, 300, 51), SequenceStatus::IN_SEQUENCE);
+    EXPECT_FALSE(tracker.book_valid());
+
+    // Stale records do not move the channel back
+    EXPECT_EQ(tracker.check(2, 1, 12), SequenceStatus::DUPLICATE);
+    EXPECT_EQ(tracker.check(2, 1, 15), SequenceStatus::IN_SEQUENCE);
+
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].channel_id, 1);
+    EXPECT_EQ(events[0].expected, 11u);
+    EXPECT_EQ(events[0].received, 14u);
+    EXPECT_EQ(events[1].expected, 15u);
+    EXPECT_EQ(events[1].received, 12u);
+
+    const auto stats = tracker.stats();
+    EXPECT_EQ(stats.gaps, 1u);
+    EXPECT_EQ(stats.missing, 3u);
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(stats.channels, 2u);
+
+    tracker.revalidate();
+    EXPECT_TRUE(tracker.book_valid());
+    tracker.reset();
+    EXPECT_EQ(tracker.stats().channels, 0u);
+    EXPECT_EQ(tracker.check(2, 1, 3), SequenceStatus::IN_SEQUENCE);
+}
+
+} // namespace test
+} // namespace orderbook
@@ -0,0 +1,109 @@
+#include "book_query.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " <input.csv> TIME [TIME...] [options]\n"
+              << "  TIME                     ts_event, ISO 8601 UTC or nanoseconds since epoch; the book\n"
+              << "                           holds every record before the first one past TIME\n"
+              << "  --depth N                Levels per side (default 10, 0 = full book)\n"
+              << "  --orders                 L3: list each level's orders\n"
+              << "  --index FILE             Index sidecar (default <input.csv>.idx, built by mbo_index)\n"
+              << "  --cache N                Book states kept in the LRU cache (default 8)\n";
+}
+
+orderbook::timestamp_t parse_time(const std::string& value) {
+    const auto ts = orderbook::CSVParser::parse_time_argument(value);
+    if (!ts) {
+        throw std::invalid_argument("Cannot parse time: " + value);
+    }
+    return *ts;
+}
+
+void print_side(const char* name, const std::vector<orderbook::BookLevel>& levels) {
+    for (const auto& level : levels) {
+        std::cout << "  " << name << std::setw(16) << orderbook::CSVParser::format_price(level.price)
+                  << std::setw(10) << level.size << std::setw(7) << level.count << "\n";
+        for (const auto& [order_id, size] : level.orders) {
+            std::cout << "        order " << std::setw(20) << order_id << std::setw(10) << size << "\n";
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace orderbook;
+
+    if (argc < 3 || argv[1][0] == '-') {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        const std::string input_file = argv[1];
+        std::string index_file = ReplayIndex::default_path(input_file);
+        std::vector<timestamp_t> times;
+        std::size_t depth = MAX_DEPTH;
+        std::size_t cache_states = 8;
+        bool orders = false;
+
+        for (int i = 2; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--orders") {
+                orders = true;
+                continue;
+            }
+            if (arg.rfind("--", 0) != 0) {
+                times.push_back(parse_time(arg));
+                continue;
+            }
+            if (i + 1 >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--depth") {
+                depth = std::stoull(value);
+            } else if (arg == "--index") {
+                index_file = value;
+            } else if (arg == "--cache") {
+                cache_states = std::stoull(value);
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+        if (times.empty()) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        BookQuery query(input_file, ReplayIndex::load(index_file), cache_states);
+        for (timestamp_t ts : times) {
+            const auto start = std::chrono::steady_clock::now();
+            const auto book = query.book_at(ts, depth, orders);
+            const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+            std::cout << "Book at " << CSVParser::format_timestamp(ts) << " (record " << book.position.records
+                      << ", sequence " << book.position.sequence << ", " << std::fixed << std::setprecision(2)
+                      << elapsed.count() << " ms)\n";
+            print_side("ask", std::vector<BookLevel>(book.asks.rbegin(), book.asks.rend()));
+            print_side("bid", book.bids);
+        }
+
+        const auto& stats = query.stats();
+        std::cout << "Queries: " << stats.queries << ", cache hits: " << stats.cache_hits
+                  << ", checkpoint loads: " << stats.checkpoint_loads
+                  << ", records replayed: " << stats.records_replayed << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
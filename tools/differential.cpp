@@ -0,0 +1,113 @@
+#include "differential.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --lines N          Generated lines, each also fuzzed (default 100000)\n"
+              << "  --streams N        Record streams per engine (default 200)\n"
+              << "  --stream-length N  Records per stream (default 2000)\n"
+              << "  --seed S           Random seed (default 1)\n"
+              << "  --parsers P,P,...  Candidate parsers (default all but the reference)\n"
+              << "  --engines E,E,...  Candidate engines (default all but the reference)\n"
+              << "  --max-failures N   Stop after N failures (default 10)\n"
+              << "Exits with status 1 when any candidate differs from the reference.\n";
+}
+
+std::vector<std::string> split_list(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        orderbook::DifferentialConfig config;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--lines") {
+                config.lines = std::stoull(value);
+            } else if (arg == "--streams") {
+                config.streams = std::stoull(value);
+            } else if (arg == "--stream-length") {
+                config.stream_length = std::stoull(value);
+            } else if (arg == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (arg == "--parsers") {
+                config.parsers = split_list(value);
+            } else if (arg == "--engines") {
+                config.engines = split_list(value);
+            } else if (arg == "--max-failures") {
+                config.max_failures = std::stoull(value);
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+
+        // Validate names up front
+        for (const auto& name : config.parsers) {
+            orderbook::find_line_parser(name);
+        }
+        for (const auto& name : config.engines) {
+            orderbook::create_book_engine(name);
+        }
+
+        std::cout << "Differential check against reference parser '"
+                  << orderbook::registered_line_parsers().front().name << "' and engine '"
+                  << orderbook::registered_book_engines().front().name << "'\n";
+        if (orderbook::registered_line_parsers().size() == 1 || orderbook::registered_book_engines().size() == 1) {
+            std::cout << "(references without alternatives are checked against themselves)\n";
+        }
+
+        const orderbook::DifferentialReport report = orderbook::run_differential(config);
+
+        std::cout << "Parser cases: " << report.parser_cases << "\n"
+                  << "Engine streams: " << report.engine_streams
+                  << " (" << report.engine_records << " records)\n";
+
+        for (const auto& failure : report.failures) {
+            std::cout << "\nMISMATCH " << failure.kind << " '" << failure.candidate << "': "
+                      << failure.detail << "\n"
+                      << "  minimized from " << failure.original_size << " to " << failure.minimized_size
+                      << (failure.kind == "parser" ? " bytes:\n" : " records:\n");
+            std::istringstream input(failure.input);
+            std::string line;
+            while (std::getline(input, line)) {
+                std::cout << "    " << line << "\n";
+            }
+        }
+
+        std::cout << (report.passed() ? "\nAll candidates match the reference\n"
+                                      : "\n" + std::to_string(report.failures.size()) + " mismatch(es)\n");
+        return report.passed() ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,95 @@
+#include "market_generator.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --records N        Records to generate (default 1000000)\n"
+              << "  --output FILE      Output CSV file (default stdout)\n"
+              << "  --seed S           Random seed (default 42)\n"
+              << "  --instruments K    Number of instruments (default 1)\n"
+              << "  --channels C       Number of channels (default 1)\n"
+              << "  --rate R           Events per second (default 50000)\n"
+              << "  --resting N        Target resting orders per instrument (default 1000)\n"
+              << "  --initial-depth N  Adds per instrument before the stream (default 0)\n"
+              << "  --level-distance D Mean distance from the touch in ticks (default 4)\n"
+              << "  --cancel-ratio X   Cancel-to-add ratio (default 0.95)\n"
+              << "  --trade-prob P     Probability an event is a trade (default 0.03)\n"
+              << "Example: " << program << " --records 5000000 --output mbo.csv\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        orderbook::MarketGeneratorConfig config;
+        std::size_t records = 1000000;
+        std::string output_file;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--records") {
+                records = std::stoull(value);
+            } else if (arg == "--output") {
+                output_file = value;
+            } else if (arg == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (arg == "--instruments") {
+                config.instrument_count = std::stoull(value);
+            } else if (arg == "--channels") {
+                config.channel_count = static_cast<std::uint16_t>(std::stoul(value));
+            } else if (arg == "--rate") {
+                config.events_per_second = std::stod(value);
+            } else if (arg == "--resting") {
+                config.target_resting_orders = std::stoull(value);
+            } else if (arg == "--initial-depth") {
+                config.initial_depth = std::stoull(value);
+            } else if (arg == "--level-distance") {
+                config.mean_level_distance = std::stod(value);
+            } else if (arg == "--cancel-ratio") {
+                config.cancel_to_add_ratio = std::stod(value);
+            } else if (arg == "--trade-prob") {
+                config.trade_probability = std::stod(value);
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+
+        orderbook::MarketGenerator generator(config);
+
+        if (output_file.empty()) {
+            std::ios::sync_with_stdio(false);
+            generator.write_csv(std::cout, records);
+        } else {
+            std::ofstream output(output_file);
+            if (!output.is_open()) {
+                std::cerr << "Error: cannot open output file: " << output_file << "\n";
+                return 1;
+            }
+            generator.write_csv(output, records);
+            std::cerr << "Wrote " << records << " records to " << output_file << "\n";
+        }
+
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
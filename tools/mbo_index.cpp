@@ -0,0 +1,104 @@
+#include "orderbook.hpp"
+#include "replay_index.hpp"
+#include <iostream>
+#include <string>
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " build <input.csv> [options]\n"
+              << "       " << program << " window <input.csv> --from T0 --to T1 [options]\n"
+              << "  --index FILE             Index sidecar (default <input.csv>.idx)\n"
+              << "build:\n"
+              << "  --every N                Entry every N records (default 100000)\n"
+              << "  --every-ms T             ...or every T ms of event time (default 1000, 0 = off)\n"
+              << "  --checkpoint-every K     Book checkpoint at every K-th entry (default 0 = none)\n"
+              << "  --checkpoint-dir DIR     Checkpoint directory (default <index>.ckpt)\n"
+              << "window:\n"
+              << "  --from T0 --to T1        ts_event bounds, ISO 8601 UTC or nanoseconds since epoch\n"
+              << "  --output FILE            MBP output (default window_mbp.csv)\n";
+}
+
+orderbook::timestamp_t parse_time(const std::string& value) {
+    const auto ts = orderbook::CSVParser::parse_time_argument(value);
+    if (!ts) {
+        throw std::invalid_argument("Cannot parse time: " + value);
+    }
+    return *ts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace orderbook;
+
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        const std::string command = argv[1];
+        const std::string input_file = argv[2];
+        std::string index_file = ReplayIndex::default_path(input_file);
+        std::string output_file = "window_mbp.csv";
+        IndexConfig config;
+        std::optional<timestamp_t> from;
+        std::optional<timestamp_t> to;
+
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--index") {
+                index_file = value;
+            } else if (arg == "--every") {
+                config.every_records = std::stoull(value);
+            } else if (arg == "--every-ms") {
+                config.every_ms = std::stoll(value);
+            } else if (arg == "--checkpoint-every") {
+                config.checkpoint_every = std::stoull(value);
+            } else if (arg == "--checkpoint-dir") {
+                config.checkpoint_dir = value;
+            } else if (arg == "--from") {
+                from = parse_time(value);
+            } else if (arg == "--to") {
+                to = parse_time(value);
+            } else if (arg == "--output") {
+                output_file = value;
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+
+        if (command == "build") {
+            const auto index = ReplayIndex::build(input_file, index_file, config);
+            const auto checkpoints = std::count_if(index.entries().begin(), index.entries().end(),
+                                                   [](const IndexEntry& entry) { return entry.has_checkpoint; });
+            std::cout << "Indexed " << input_file << ": " << index.entries().size() << " entries, "
+                      << checkpoints << " checkpoints -> " << index_file << "\n";
+            return 0;
+        }
+        if (command == "window") {
+            if (!from || !to) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            const auto index = ReplayIndex::load(index_file);
+            OrderbookProcessor processor;
+            processor.process_window(input_file, output_file, index, *from, *to);
+            std::cout << "Output written to: " << output_file << "\n";
+            return 0;
+        }
+        print_usage(argv[0]);
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}